@@ -0,0 +1,284 @@
+#include "BatchPricer.hpp"
+#include "MappedFile.hpp"
+#include "../grid/GridParameters.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include "../solvers/SolverWorkspace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr int kCsvFields = 9;
+
+inline std::string trim(const std::string& s, std::size_t begin, std::size_t end)
+{
+    while (begin < end && (s[begin] == ' ' || s[begin] == '\t')) ++begin;
+    while (end > begin && (s[end - 1] == ' ' || s[end - 1] == '\t' || s[end - 1] == '\r')) --end;
+    return s.substr(begin, end - begin);
+}
+
+inline double toDouble(const std::string& field, const char* what)
+{
+    if (field.empty()) throw std::invalid_argument(std::string("Missing ") + what + ".");
+    char* end = nullptr;
+    const double x = std::strtod(field.c_str(), &end);
+    if (end != field.c_str() + field.size())
+        throw std::invalid_argument(std::string("Invalid ") + what + " '" + field + "'.");
+    return x;
+}
+
+} // namespace
+
+BatchPricer::BatchPricer(ThreadPool* pool)
+    : BatchPricer(Config(), pool)
+{
+}
+
+BatchPricer::BatchPricer(const Config& config, ThreadPool* pool)
+    : config_(config), pool_(pool)
+{
+    if (config_.chunkSize == 0) throw std::invalid_argument("chunkSize must be > 0.");
+    solver_.setPrecision(config_.precision);
+}
+
+TradeResult BatchPricer::price(const Trade& trade, SolverWorkspace& ws) const
+{
+    TradeResult out;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    try {
+        if (!(trade.S0 > 0.0)) throw std::invalid_argument("Spot S0 must be > 0.");
+
+        const BlackScholesModel model(trade.r, trade.sigma, trade.q);
+        const auto product = ProductFactory::make(trade.type, trade.K1, trade.K2, trade.T, model);
+
+        if (config_.analytic && AnalyticBsPricer::supports(*product)) {
+            const auto res = analytic_.price(*product, model, trade.S0);
+            out.price = res.price;
+            out.delta = res.delta;
+            out.gamma = res.gamma;
+        } else {
+            const FdGrid grid = GridParameters::makeGrid(*product, model, trade.S0, trade.rel_dS);
+            const auto res = solver_.price(*product, model, grid, trade.S0, ws, false);
+            out.price = res.price;
+            out.delta = res.delta;
+            out.gamma = res.gamma;
+            out.Nt = grid.Nt();
+            out.Ns = grid.Ns();
+            out.stats = res.stats;
+        }
+    } catch (const std::exception& e) {
+        out.error = e.what();
+    }
+
+    out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return out;
+}
+
+void BatchPricer::priceChunk(const std::vector<Trade>& trades, std::vector<TradeResult>& results) const
+{
+    if (results.size() != trades.size())
+        throw std::invalid_argument("priceChunk: results and trades sizes differ.");
+
+    const int N = static_cast<int>(trades.size());
+
+    if (!pool_ || pool_->size() == 1 || N < 2) {
+        SolverWorkspace& ws = SolverWorkspace::threadLocal();
+        for (int k = 0; k < N; ++k) {
+            if (results[k].ok()) results[k] = price(trades[k], ws);
+        }
+        return;
+    }
+
+    // Each participant solves on its own thread: its thread-local workspace
+    // is private and stays warm across chunks
+    pool_->parallelFor(N, [&](int k, int /*participant*/) {
+        if (results[k].ok()) results[k] = price(trades[k], SolverWorkspace::threadLocal());
+    });
+}
+
+BatchPricer::Stats BatchPricer::runCsv(std::istream& in, std::ostream& out) const
+{
+    Stats stats;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<Trade> trades;
+    std::vector<TradeResult> results;
+    std::vector<std::size_t> lines;      // input line of each trade
+    std::string line, text;
+    trades.reserve(config_.chunkSize);
+    results.reserve(config_.chunkSize);
+    lines.reserve(config_.chunkSize);
+
+    writeCsvHeader(out);
+
+    std::size_t lineNo = 0;
+    bool more = true;
+    while (more) {
+        // 1) Parse up to chunkSize trades
+        trades.clear();
+        results.clear();
+        lines.clear();
+        while (trades.size() < config_.chunkSize) {
+            if (!std::getline(in, line)) {
+                more = false;
+                break;
+            }
+            ++lineNo;
+
+            Trade trade;
+            TradeResult result;
+            try {
+                if (!parseCsv(line, trade)) continue;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            trades.push_back(trade);
+            results.push_back(std::move(result));
+            lines.push_back(lineNo);
+        }
+        if (trades.empty()) break;
+
+        // 2) Price across the pool, 3) write in input order
+        priceChunk(trades, results);
+
+        text.clear();
+        for (std::size_t k = 0; k < trades.size(); ++k) {
+            appendCsv(text, lines[k], trades[k], results[k]);
+            if (!results[k].ok()) ++stats.failed;
+            if constexpr (solver_stats::kEnabled) {
+                if (results[k].stats.Nt > 0)
+                    StatsRegistry::global().record(results[k].stats, "line " + std::to_string(lines[k]));
+            }
+        }
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        stats.trades += trades.size();
+    }
+
+    out.flush();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return stats;
+}
+
+void BatchPricer::priceRecords(const Trade* trades, ResultRecord* results, std::size_t n) const
+{
+    auto store = [&](std::size_t k, SolverWorkspace& ws) {
+        const TradeResult res = price(trades[k], ws);
+        ResultRecord& rec = results[k];
+        rec.price = res.price;
+        rec.delta = res.delta;
+        rec.gamma = res.gamma;
+        rec.seconds = res.seconds;
+        rec.Nt = res.Nt;
+        rec.Ns = res.Ns;
+        rec.status = res.ok() ? ResultRecord::Ok : ResultRecord::Failed;
+        rec.reserved = 0;
+        if constexpr (solver_stats::kEnabled) {
+            if (res.stats.Nt > 0) StatsRegistry::global().record(res.stats, "record " + std::to_string(k));
+        }
+    };
+
+    for (std::size_t begin = 0; begin < n; begin += config_.chunkSize) {
+        const std::size_t count = std::min(config_.chunkSize, n - begin);
+
+        if (!pool_ || pool_->size() == 1 || count < 2) {
+            SolverWorkspace& ws = SolverWorkspace::threadLocal();
+            for (std::size_t k = begin; k < begin + count; ++k) store(k, ws);
+            continue;
+        }
+
+        pool_->parallelFor(static_cast<int>(count), [&](int k, int /*participant*/) {
+            store(begin + static_cast<std::size_t>(k), SolverWorkspace::threadLocal());
+        });
+    }
+}
+
+BatchPricer::Stats BatchPricer::runBinary(const std::string& tradesPath, const std::string& resultsPath) const
+{
+    Stats stats;
+    const auto t0 = std::chrono::steady_clock::now();
+
+    const MappedFile in = MappedFile::openRead(tradesPath);
+    if (in.size() < sizeof(RecordFileHeader)) throw std::runtime_error("Not a trade record file: " + tradesPath);
+    const auto& header = *reinterpret_cast<const RecordFileHeader*>(in.data());
+    TradeRecords::validate(header, TradeRecords::FileKind::Trades, in.size());
+
+    const std::size_t n = static_cast<std::size_t>(header.count);
+    MappedFile out = MappedFile::create(resultsPath, sizeof(RecordFileHeader) + n * sizeof(ResultRecord));
+    const RecordFileHeader outHeader = TradeRecords::makeHeader(TradeRecords::FileKind::Results, n);
+    std::memcpy(out.data(), &outHeader, sizeof(outHeader));
+
+    const auto* trades = reinterpret_cast<const Trade*>(in.data() + sizeof(RecordFileHeader));
+    auto* results = reinterpret_cast<ResultRecord*>(out.data() + sizeof(RecordFileHeader));
+    priceRecords(trades, results, n);
+
+    stats.trades = n;
+    for (std::size_t k = 0; k < n; ++k) stats.failed += (results[k].status != ResultRecord::Ok);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return stats;
+}
+
+bool BatchPricer::parseCsv(const std::string& line, Trade& trade)
+{
+    std::string fields[kCsvFields];
+    int n = 0;
+    std::size_t begin = 0;
+    while (true) {
+        const std::size_t comma = line.find(',', begin);
+        const std::size_t end = (comma == std::string::npos) ? line.size() : comma;
+        if (n == kCsvFields) throw std::invalid_argument("Too many fields (expected 9).");
+        fields[n++] = trim(line, begin, end);
+        if (comma == std::string::npos) break;
+        begin = comma + 1;
+    }
+
+    if (n == 1 && fields[0].empty()) return false;               // blank line
+    if (!fields[0].empty() && fields[0][0] == '#') return false; // comment
+    if (fields[0] == "type") return false;                       // header
+    if (n != kCsvFields) throw std::invalid_argument("Expected 9 fields: type,K1,K2,T,S0,r,sigma,q,rel_dS.");
+
+    trade.type = ProductFactory::parse(fields[0]);
+    trade.K1 = toDouble(fields[1], "K1");
+    trade.K2 = (fields[2].empty() && !ProductFactory::readsK2(trade.type)) ? 0.0 : toDouble(fields[2], "K2");
+    trade.T = toDouble(fields[3], "T");
+    trade.S0 = toDouble(fields[4], "S0");
+    trade.r = toDouble(fields[5], "r");
+    trade.sigma = toDouble(fields[6], "sigma");
+    trade.q = toDouble(fields[7], "q");
+    trade.rel_dS = toDouble(fields[8], "rel_dS");
+    return true;
+}
+
+void BatchPricer::writeCsvHeader(std::ostream& out)
+{
+    out << "line,type,price,delta,gamma,Nt,Ns,micros,error\n";
+}
+
+void BatchPricer::appendCsv(std::string& out, std::size_t line, const Trade& trade, const TradeResult& result)
+{
+    char buf[256];
+    if (result.ok()) {
+        const int len = std::snprintf(buf, sizeof(buf), "%zu,%s,%.10g,%.10g,%.10g,%d,%d,%.1f,\n",
+                                      line, ProductFactory::name(trade.type),
+                                      result.price, result.delta, result.gamma,
+                                      result.Nt, result.Ns, result.seconds * 1e6);
+        out.append(buf, static_cast<std::size_t>(len));
+        return;
+    }
+
+    // The trade may not have parsed: only its line identifies it. Commas
+    // would break the row, so the message is quoted.
+    std::string msg = result.error;
+    for (char& c : msg) if (c == '"') c = '\'';
+    const int len = std::snprintf(buf, sizeof(buf), "%zu,,,,,,,,", line);
+    out.append(buf, static_cast<std::size_t>(len));
+    out += '"';
+    out += msg;
+    out += "\"\n";
+}
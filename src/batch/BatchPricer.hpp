@@ -0,0 +1,98 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "TradeRecords.hpp"
+#include "../solvers/AnalyticBsPricer.hpp"
+#include "../solvers/ExplicitFdSolver.hpp"
+
+class ThreadPool;
+class SolverWorkspace;
+
+/**
+ * File-driven batch pricing
+ *
+ * Trades are streamed in chunks: each chunk is parsed, priced across the
+ * thread pool (one SolverWorkspace per participant, trades handed out
+ * dynamically) and written in input order before the next one is read, so
+ * memory stays bounded by the chunk size whatever the file length.
+ * Each trade is rolled back by the explicit solver on its own
+ * GridParameters::makeGrid grid; with Config::analytic, products with a
+ * closed form skip the PDE.
+ *
+ * CSV input, one trade per line (header line and '#' comments skipped):
+ *   type,K1,K2,T,S0,r,sigma,q,rel_dS
+ * type is a ProductFactory tag (american_put, bull_call_spread, ...);
+ * K2 is only read by the spreads (upper strike) and the knock-out options
+ * (barrier), and may be left empty otherwise.
+ * A malformed or unpriceable trade gets an error message in its output
+ * row instead of stopping the run.
+ *
+ * Binary input (TradeRecords) skips parsing altogether: the trade file is
+ * mapped and its records priced in place into a mapped result file.
+ *
+ * In BS_SOLVER_STATS builds every PDE solve is also recorded in
+ * StatsRegistry::global(), tagged with its input line or record index.
+ */
+struct TradeResult {
+    double price = 0.0;
+    double delta = 0.0;
+    double gamma = 0.0;
+    int Nt = 0;                 // grid size (0 for closed form)
+    int Ns = 0;
+    double seconds = 0.0;       // wall time of this trade
+    SolveStats stats;           // PDE solve statistics (BS_SOLVER_STATS builds)
+    std::string error;          // empty if priced
+
+    bool ok() const { return error.empty(); }
+};
+
+class BatchPricer {
+public:
+    struct Config {
+        std::size_t chunkSize = 4096;   // trades per chunk
+        bool analytic = false;          // closed form where available
+        ExplicitFdSolver::Precision precision = ExplicitFdSolver::Precision::Double;   // PDE sweeps
+    };
+
+    struct Stats {
+        std::size_t trades = 0;
+        std::size_t failed = 0;
+        double seconds = 0.0;
+    };
+
+    // pool: nullptr prices serially. The pool must outlive the pricer.
+    explicit BatchPricer(ThreadPool* pool = nullptr);
+    BatchPricer(const Config& config, ThreadPool* pool = nullptr);
+
+    const Config& config() const { return config_; }
+
+    TradeResult price(const Trade& trade, SolverWorkspace& ws) const;
+
+    // results must have the size of trades; entries that already carry an
+    // error (e.g. from parsing) are left untouched
+    void priceChunk(const std::vector<Trade>& trades, std::vector<TradeResult>& results) const;
+
+    // Prices n trade records into n result records, chunk by chunk
+    void priceRecords(const Trade* trades, ResultRecord* results, std::size_t n) const;
+
+    // Streams CSV trades from in to CSV results on out
+    Stats runCsv(std::istream& in, std::ostream& out) const;
+
+    // Maps a trade record file and writes a result record file of the same
+    // count (created or overwritten)
+    Stats runBinary(const std::string& tradesPath, const std::string& resultsPath) const;
+
+    // CSV codec, one line at a time. parseCsv returns false on a header,
+    // blank or comment line; it throws std::invalid_argument on a malformed one.
+    static bool parseCsv(const std::string& line, Trade& trade);
+    static void writeCsvHeader(std::ostream& out);
+    static void appendCsv(std::string& out, std::size_t line, const Trade& trade, const TradeResult& result);
+
+private:
+    Config config_;
+    ThreadPool* pool_;
+    ExplicitFdSolver solver_;
+    AnalyticBsPricer analytic_;
+};
@@ -0,0 +1,44 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "batch/TradeRecords.hpp"
+
+// bs_convert IN OUT: converts between CSV and the binary record files.
+// The direction follows IN: a trade or result record file is written out
+// as CSV, anything else is read as trade CSV and written as records.
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: bs_convert trades.csv trades.bin     (CSV -> trade records)\n"
+                  << "       bs_convert trades.bin trades.csv|-   (trade records -> CSV)\n"
+                  << "       bs_convert results.bin results.csv|- (result records -> CSV)\n";
+        return 1;
+    }
+    const std::string inPath = argv[1], outPath = argv[2];
+
+    try {
+        const auto kind = TradeRecords::detect(inPath);
+        std::size_t count = 0;
+
+        if (kind == TradeRecords::FileKind::Unknown) {
+            if (outPath == "-") throw std::runtime_error("Record output needs a file path.");
+            std::ifstream in(inPath);
+            if (!in) throw std::runtime_error("Cannot open " + inPath);
+            count = TradeRecords::csvToTrades(in, outPath);
+        } else {
+            std::ofstream outFile;
+            if (outPath != "-") {
+                outFile.open(outPath);
+                if (!outFile) throw std::runtime_error("Cannot open " + outPath);
+            }
+            std::ostream& out = (outPath == "-") ? std::cout : outFile;
+            count = (kind == TradeRecords::FileKind::Trades) ? TradeRecords::tradesToCsv(inPath, out)
+                                                             : TradeRecords::resultsToCsv(inPath, out);
+        }
+
+        std::cerr << "Converted " << count << " records\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
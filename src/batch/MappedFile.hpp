@@ -0,0 +1,33 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * Memory-mapped file (POSIX mmap), move-only.
+ * openRead maps an existing file read-only; create truncates or creates
+ * the file at the given size and maps it read-write (shared, so writes
+ * land in the file). Errors throw std::runtime_error.
+ */
+class MappedFile {
+public:
+    static MappedFile openRead(const std::string& path);
+    static MappedFile create(const std::string& path, std::size_t bytes);
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    char* data() { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    void release();
+
+    char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
@@ -0,0 +1,144 @@
+#include "TradeRecords.hpp"
+#include "BatchPricer.hpp"
+#include "MappedFile.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+const char* magicOf(TradeRecords::FileKind kind)
+{
+    return kind == TradeRecords::FileKind::Trades ? TradeRecords::kTradesMagic : TradeRecords::kResultsMagic;
+}
+
+std::uint32_t recordSizeOf(TradeRecords::FileKind kind)
+{
+    return kind == TradeRecords::FileKind::Trades ? sizeof(Trade) : sizeof(ResultRecord);
+}
+
+// Maps a record file and returns its header, validated for `kind`
+const RecordFileHeader& mapRecords(const std::string& path, TradeRecords::FileKind kind, MappedFile& file)
+{
+    file = MappedFile::openRead(path);
+    if (file.size() < sizeof(RecordFileHeader))
+        throw std::runtime_error("Not a record file (too short): " + path);
+
+    const auto& header = *reinterpret_cast<const RecordFileHeader*>(file.data());
+    TradeRecords::validate(header, kind, file.size());
+    return header;
+}
+
+} // namespace
+
+namespace TradeRecords {
+
+RecordFileHeader makeHeader(FileKind kind, std::uint64_t count)
+{
+    RecordFileHeader header{};
+    std::memcpy(header.magic, magicOf(kind), sizeof(header.magic));
+    header.version = kVersion;
+    header.recordSize = recordSizeOf(kind);
+    header.count = count;
+    return header;
+}
+
+void validate(const RecordFileHeader& header, FileKind kind, std::size_t bytes)
+{
+    if (std::memcmp(header.magic, magicOf(kind), sizeof(header.magic)) != 0)
+        throw std::runtime_error(kind == FileKind::Trades ? "Not a trade record file." : "Not a result record file.");
+    if (header.version != kVersion)
+        throw std::runtime_error("Unsupported record file version " + std::to_string(header.version) + ".");
+    if (header.recordSize != recordSizeOf(kind))
+        throw std::runtime_error("Record size mismatch (file written by another layout).");
+    if (header.count > (bytes - sizeof(RecordFileHeader)) / header.recordSize)
+        throw std::runtime_error("Record file truncated.");
+}
+
+FileKind detect(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    char magic[8] = {};
+    if (!in.read(magic, sizeof(magic))) return FileKind::Unknown;
+    if (std::memcmp(magic, kTradesMagic, sizeof(magic)) == 0) return FileKind::Trades;
+    if (std::memcmp(magic, kResultsMagic, sizeof(magic)) == 0) return FileKind::Results;
+    return FileKind::Unknown;
+}
+
+std::size_t csvToTrades(std::istream& csv, const std::string& binPath)
+{
+    std::ofstream out(binPath, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::runtime_error("Cannot create " + binPath);
+
+    // Count unknown until the end: placeholder header, rewritten last
+    RecordFileHeader header = makeHeader(FileKind::Trades, 0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::string line;
+    std::size_t lineNo = 0, count = 0;
+    while (std::getline(csv, line)) {
+        ++lineNo;
+        Trade trade;
+        try {
+            if (!BatchPricer::parseCsv(line, trade)) continue;
+        } catch (const std::exception& e) {
+            out.close();
+            std::remove(binPath.c_str());   // no half-written record file
+            throw std::runtime_error("Line " + std::to_string(lineNo) + ": " + e.what());
+        }
+        out.write(reinterpret_cast<const char*>(&trade), sizeof(trade));
+        ++count;
+    }
+
+    header.count = count;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!out) throw std::runtime_error("Write failed: " + binPath);
+    return count;
+}
+
+std::size_t tradesToCsv(const std::string& binPath, std::ostream& csv)
+{
+    MappedFile file;
+    const RecordFileHeader& header = mapRecords(binPath, FileKind::Trades, file);
+    const auto* trades = reinterpret_cast<const Trade*>(file.data() + sizeof(RecordFileHeader));
+
+    csv << "type,K1,K2,T,S0,r,sigma,q,rel_dS\n";
+    char buf[320];
+    for (std::uint64_t k = 0; k < header.count; ++k) {
+        const Trade& t = trades[k];
+        char k2[32] = "";
+        if (ProductFactory::readsK2(t.type)) std::snprintf(k2, sizeof(k2), "%.17g", t.K2);
+        const int len = std::snprintf(buf, sizeof(buf), "%s,%.17g,%s,%.17g,%.17g,%.17g,%.17g,%.17g,%.17g\n",
+                                      ProductFactory::name(t.type), t.K1, k2, t.T, t.S0,
+                                      t.r, t.sigma, t.q, t.rel_dS);
+        csv.write(buf, len);
+    }
+    return static_cast<std::size_t>(header.count);
+}
+
+std::size_t resultsToCsv(const std::string& binPath, std::ostream& csv)
+{
+    MappedFile file;
+    const RecordFileHeader& header = mapRecords(binPath, FileKind::Results, file);
+    const auto* results = reinterpret_cast<const ResultRecord*>(file.data() + sizeof(RecordFileHeader));
+
+    csv << "record,price,delta,gamma,Nt,Ns,micros,status\n";
+    char buf[256];
+    for (std::uint64_t k = 0; k < header.count; ++k) {
+        const ResultRecord& res = results[k];
+        const int len = (res.status == ResultRecord::Ok)
+            ? std::snprintf(buf, sizeof(buf), "%llu,%.10g,%.10g,%.10g,%d,%d,%.1f,ok\n",
+                            static_cast<unsigned long long>(k), res.price, res.delta, res.gamma,
+                            res.Nt, res.Ns, res.seconds * 1e6)
+            : std::snprintf(buf, sizeof(buf), "%llu,,,,,,%.1f,failed\n",
+                            static_cast<unsigned long long>(k), res.seconds * 1e6);
+        csv.write(buf, len);
+    }
+    return static_cast<std::size_t>(header.count);
+}
+
+} // namespace TradeRecords
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include "../products/ProductFactory.hpp"
+
+/**
+ * Fixed-record binary files for batch pricing (version 1)
+ *
+ * A file is a RecordFileHeader followed by `count` fixed-size records,
+ * native byte order (little-endian on every supported host) and 8-byte
+ * alignment, so a mapped file is read and written in place: a trade
+ * record is the Trade struct itself, whose fields are exactly the
+ * arguments of ProductFactory::make and BlackScholesModel.
+ *
+ *   trades  : magic "BSTRADES", records Trade        (72 bytes)
+ *   results : magic "BSRESULT", records ResultRecord (48 bytes),
+ *             result k belongs to trade k
+ */
+struct Trade {
+    ProductType type = ProductType::EuropeanCall;
+    std::uint32_t reserved = 0;
+    double K1 = 0.0;
+    double K2 = 0.0;            // spreads: upper strike; knock-outs: barrier
+    double T = 0.0;
+    double S0 = 0.0;
+    double r = 0.0;
+    double sigma = 0.0;
+    double q = 0.0;
+    double rel_dS = 0.0;
+};
+
+struct ResultRecord {
+    enum Status : std::uint32_t { Ok = 0, Failed = 1 };
+
+    double price;
+    double delta;
+    double gamma;
+    double seconds;             // wall time of this trade
+    std::int32_t Nt;            // grid size (0 for closed form)
+    std::int32_t Ns;
+    std::uint32_t status;
+    std::uint32_t reserved;
+};
+
+struct RecordFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;   // sizeof(record), checked on open
+    std::uint64_t count;
+    std::uint64_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<Trade>::value && std::is_standard_layout<Trade>::value,
+              "Trade is mapped from files");
+static_assert(sizeof(ProductType) == 4 && sizeof(Trade) == 72, "Trade record layout changed");
+static_assert(sizeof(ResultRecord) == 48 && sizeof(RecordFileHeader) == 32, "Record layout changed");
+
+namespace TradeRecords {
+
+constexpr std::uint32_t kVersion = 1;
+constexpr char kTradesMagic[8]  = {'B', 'S', 'T', 'R', 'A', 'D', 'E', 'S'};
+constexpr char kResultsMagic[8] = {'B', 'S', 'R', 'E', 'S', 'U', 'L', 'T'};
+
+enum class FileKind { Trades, Results, Unknown };
+
+RecordFileHeader makeHeader(FileKind kind, std::uint64_t count);
+
+// Checks magic, version, record size and that `bytes` holds every record;
+// throws std::runtime_error otherwise
+void validate(const RecordFileHeader& header, FileKind kind, std::size_t bytes);
+
+// Kind of the file at path, from its magic (Unknown for text files)
+FileKind detect(const std::string& path);
+
+// CSV <-> binary converters. csvToTrades streams the CSV (BatchPricer
+// format) and throws std::runtime_error naming the line of a malformed
+// trade; it returns the number of records written.
+std::size_t csvToTrades(std::istream& csv, const std::string& binPath);
+std::size_t tradesToCsv(const std::string& binPath, std::ostream& csv);
+std::size_t resultsToCsv(const std::string& binPath, std::ostream& csv);
+
+} // namespace TradeRecords
@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "model/BlackScholesModel.hpp"
+#include "grid/FdGrid.hpp"
+#include "grid/GridParameters.hpp"
+#include "parallel/ThreadPool.hpp"
+#include "products/AmericanPut.hpp"
+#include "products/ProductFactory.hpp"
+#include "products/SpreadOption.hpp"
+#include "solvers/AdiFdSolver.hpp"
+#include "solvers/AnalyticBsPricer.hpp"
+#include "solvers/ExplicitFdSolver.hpp"
+#include "solvers/ScenarioPricer.hpp"
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every global operator new of the process goes through
+// these replacements, so a window [before, after) counts the heap traffic of
+// the code it brackets (all threads).
+// ---------------------------------------------------------------------------
+static std::atomic<std::size_t> gAllocations(0);
+static std::atomic<std::size_t> gAllocatedBytes(0);
+
+static void* countedAlloc(std::size_t bytes, std::size_t alignment) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (bytes == 0) bytes = 1;
+    void* p = (alignment <= alignof(std::max_align_t))
+        ? std::malloc(bytes)
+        : std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t bytes) { return countedAlloc(bytes, alignof(std::max_align_t)); }
+void* operator new[](std::size_t bytes) { return countedAlloc(bytes, alignof(std::max_align_t)); }
+void* operator new(std::size_t bytes, std::align_val_t al) { return countedAlloc(bytes, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t bytes, std::align_val_t al) { return countedAlloc(bytes, static_cast<std::size_t>(al)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+// Wall time of one solve, in seconds
+template <class F>
+static double timeIt(F&& f) {
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+// Median over at least minReps calls and minSeconds of total time
+template <class F>
+static double medianTime(F&& f, int minReps, double minSeconds, int* reps = nullptr) {
+    std::vector<double> t;
+    double total = 0.0;
+    while (static_cast<int>(t.size()) < minReps || total < minSeconds) {
+        t.push_back(timeIt(f));
+        total += t.back();
+        if (t.size() >= 1000000) break;
+    }
+    std::sort(t.begin(), t.end());
+    if (reps) *reps = static_cast<int>(t.size());
+    return t[t.size() / 2];
+}
+
+// ---------------------------------------------------------------------------
+// Sweep: product x rel_dS x threads for ExplicitFdSolver::price
+// ---------------------------------------------------------------------------
+struct SweepPoint {
+    std::string product;
+    double rel_dS;
+    int threads;
+    int Nt, Ns;
+    int solves;
+    double secondsPerSolve;
+    double nodeUpdatesPerSecond;
+    double modeledGBs;
+    double allocationsPerSolve;
+    double bytesAllocatedPerSolve;
+    double makeGridMicros;      // GridParameters::makeGrid (sizing + FdGrid)
+    double gridCtorMicros;      // FdGrid constructor alone
+};
+
+// Modeled DRAM/cache traffic per interior node and time step: V read, Vnew
+// write (+ write-allocate) and the A/B/C coefficients, plus the obstacle
+// read for American products
+static double bytesPerNodeStep(bool american) {
+    return american ? 56.0 : 48.0;
+}
+
+static SweepPoint benchPoint(ProductType type, double rel_dS, ThreadPool* pool, double minSeconds) {
+    const double S0 = 100.0, K = 100.0, T = 1.0;
+    const double r = 0.05, sigma = 0.20, q = 0.02;
+    BlackScholesModel model(r, sigma, q);
+    const auto product = ProductFactory::make(type, K, 1.2 * K, T, model);
+
+    SweepPoint pt;
+    pt.product = ProductFactory::name(type);
+    pt.rel_dS = rel_dS;
+    pt.threads = pool ? pool->size() : 1;
+
+    // Grid construction, timed apart from the solve
+    const FdGrid grid = GridParameters::makeGrid(*product, model, S0, rel_dS);
+    pt.Nt = grid.Nt();
+    pt.Ns = grid.Ns();
+    pt.makeGridMicros = 1e6 * medianTime([&] {
+        const FdGrid g = GridParameters::makeGrid(*product, model, S0, rel_dS);
+        (void)g;
+    }, 5, 0.01);
+    const double Smin = grid.priceGrid().front(), Smax = grid.priceGrid().back();
+    pt.gridCtorMicros = 1e6 * medianTime([&] {
+        const FdGrid g(T, Smax, grid.Nt(), grid.Ns(), Smin);
+        (void)g;
+    }, 5, 0.01);
+
+    ExplicitFdSolver solver;
+    if (pool) solver.setThreadPool(pool, 256);
+
+    // Warm-up: sizes the thread-local workspaces, then counts allocations
+    // of one steady-state solve
+    ExplicitFdSolver::Result res = solver.price(*product, model, grid, S0);
+    const std::size_t a0 = gAllocations.load(), b0 = gAllocatedBytes.load();
+    res = solver.price(*product, model, grid, S0);
+    pt.allocationsPerSolve = static_cast<double>(gAllocations.load() - a0);
+    pt.bytesAllocatedPerSolve = static_cast<double>(gAllocatedBytes.load() - b0);
+
+    pt.secondsPerSolve = medianTime([&] { res = solver.price(*product, model, grid, S0); }, 3, minSeconds, &pt.solves);
+
+    const double updates = static_cast<double>(grid.Ns() - 1) * grid.Nt();
+    pt.nodeUpdatesPerSecond = updates / pt.secondsPerSolve;
+    pt.modeledGBs = updates * bytesPerNodeStep(product->isAmerican()) / pt.secondsPerSolve * 1e-9;
+    return pt;
+}
+
+static void writeJson(std::ostream& out, const std::vector<SweepPoint>& points) {
+    out << std::setprecision(6);
+    out << "{\n"
+        << "  \"benchmark\": \"explicit_fd_price\",\n"
+        << "  \"schema_version\": 1,\n"
+        << "  \"simd\": \"" << stencil::name(ExplicitFdSolver().simdLevel()) << "\",\n"
+        << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+        << "  \"results\": [\n";
+    for (std::size_t k = 0; k < points.size(); ++k) {
+        const SweepPoint& p = points[k];
+        out << "    {\"product\": \"" << p.product << "\", \"rel_dS\": " << p.rel_dS
+            << ", \"threads\": " << p.threads << ", \"Nt\": " << p.Nt << ", \"Ns\": " << p.Ns
+            << ", \"solves\": " << p.solves
+            << ", \"seconds_per_solve\": " << p.secondsPerSolve
+            << ", \"node_updates_per_s\": " << p.nodeUpdatesPerSecond
+            << ", \"modeled_gb_per_s\": " << p.modeledGBs
+            << ", \"allocations_per_solve\": " << p.allocationsPerSolve
+            << ", \"bytes_allocated_per_solve\": " << p.bytesAllocatedPerSolve
+            << ", \"make_grid_us\": " << p.makeGridMicros
+            << ", \"grid_ctor_us\": " << p.gridCtorMicros << "}"
+            << (k + 1 < points.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+static void writeTable(std::ostream& out, const std::vector<SweepPoint>& points) {
+    out << "=== ExplicitFdSolver::price sweep (SIMD=" << stencil::name(ExplicitFdSolver().simdLevel()) << ") ===\n";
+    out << std::left << std::setw(18) << "product" << std::right
+        << std::setw(8) << "rel_dS" << std::setw(4) << "thr" << std::setw(9) << "Nt" << std::setw(6) << "Ns"
+        << std::setw(12) << "ms/solve" << std::setw(11) << "Mnodes/s" << std::setw(8) << "GB/s"
+        << std::setw(8) << "allocs" << std::setw(12) << "makeGrid us" << std::setw(10) << "ctor us" << "\n";
+    for (const SweepPoint& p : points) {
+        out << std::left << std::setw(18) << p.product << std::right << std::fixed
+            << std::setprecision(4) << std::setw(8) << p.rel_dS
+            << std::setw(4) << p.threads << std::setw(9) << p.Nt << std::setw(6) << p.Ns
+            << std::setprecision(3) << std::setw(12) << p.secondsPerSolve * 1e3
+            << std::setprecision(1) << std::setw(11) << p.nodeUpdatesPerSecond * 1e-6
+            << std::setprecision(2) << std::setw(8) << p.modeledGBs
+            << std::setprecision(0) << std::setw(8) << p.allocationsPerSolve
+            << std::setprecision(2) << std::setw(12) << p.makeGridMicros
+            << std::setw(10) << p.gridCtorMicros << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Temporal blocking vs the plain step-by-step sweep on a grid larger than L2.
+// Modeled DRAM traffic per node and per sweep: V read + Vnew write
+// (+ write-allocate) + A/B/C + obstacle = 48 bytes. The plain loop pays it
+// every time step, the tiled loop once per block of `depth` steps, plus the
+// halo overlap 2*depth/width.
+// ---------------------------------------------------------------------------
+static void benchTemporalBlocking(int Ns, int Nt, int depth, int width) {
+    const double S0 = 100.0, K = 100.0;
+    const double r = 0.05, sigma = 0.20, q = 0.02;
+    const double Smax = 4.0 * S0;
+    BlackScholesModel model(r, sigma, q);
+
+    // Maturity chosen so that Nt steps satisfy the explicit stability bound
+    const double dS = Smax / Ns;
+    const double dtStable = 0.45 / ((sigma * sigma * Smax * Smax) / (dS * dS) + r);
+    const double T = dtStable * Nt;
+
+    AmericanPut put(K, T, model);
+    FdGrid grid(T, Smax, Nt, Ns);
+
+    ExplicitFdSolver plain;
+    ExplicitFdSolver tiled;
+    tiled.setTemporalBlocking(depth, width);
+
+    ExplicitFdSolver::Result resPlain, resTiled;
+    const double tPlain = timeIt([&] { resPlain = plain.price(put, model, grid, S0); });
+    const double tTiled = timeIt([&] { resTiled = tiled.price(put, model, grid, S0); });
+
+    const double bytesPerNodeSweep = 48.0;
+    const double nodes = static_cast<double>(Ns + 1);
+    const double sweepsTiled = std::ceil(static_cast<double>(Nt) / depth) * (1.0 + 2.0 * depth / width);
+    const double bytesPlain = bytesPerNodeSweep * nodes * Nt;
+    const double bytesTiled = bytesPerNodeSweep * nodes * sweepsTiled;
+    const double updates = nodes * Nt;
+
+    std::cout << "=== Temporal blocking (American put, Ns=" << Ns << ", Nt=" << Nt
+              << ", SIMD=" << stencil::name(plain.simdLevel()) << ") ===\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "plain : " << tPlain << " s  " << updates / tPlain * 1e-6 << " Mnodes/s  "
+              << "modeled traffic " << bytesPlain * 1e-9 << " GB ("
+              << bytesPlain / tPlain * 1e-9 << " GB/s)\n";
+    std::cout << "tiled : " << tTiled << " s  " << updates / tTiled * 1e-6 << " Mnodes/s  "
+              << "modeled traffic " << bytesTiled * 1e-9 << " GB ("
+              << bytesTiled / tTiled * 1e-9 << " GB/s)  depth=" << depth << " width=" << width << "\n";
+    std::cout << "traffic reduction x" << bytesPlain / bytesTiled
+              << "  speed-up x" << tPlain / tTiled
+              << "  identical=" << (resPlain.V0 == resTiled.V0 ? "yes" : "NO") << "\n";
+}
+
+// ---------------------------------------------------------------------------
+// Two-asset ADI: exchange option (Craig–Sneyd) on the GridParameters grid,
+// timed per pool size; every run must match the serial grid values bitwise.
+// ---------------------------------------------------------------------------
+static void benchAdi(double rel_dS, const std::vector<int>& threads) {
+    const double S1 = 100.0, S2 = 95.0, T = 1.0;
+    const TwoAssetModel model(0.05, 0.2, 0.3, 0.5, 0.02, 0.01);
+    SpreadOption exchange(SpreadOption::Type::Call, 0.0, T);
+    const FdGrid2D grid = GridParameters::makeGrid(exchange, model, S1, S2, rel_dS);
+
+    const AdiFdSolver serial;
+    AdiFdSolver::Result reference;
+    const double tSerial = timeIt([&] { reference = serial.price(exchange, model, grid, S1, S2); });
+    const double updates = static_cast<double>(grid.size()) * grid.Nt();
+
+    std::cout << "=== Two-asset ADI (exchange option, Craig-Sneyd, " << grid.N1() + 1 << " x " << grid.N2() + 1
+              << " nodes, Nt=" << grid.Nt() << ") ===\n";
+    std::cout << std::fixed << std::setprecision(6) << "price " << reference.price << "  Margrabe "
+              << AnalyticBsPricer::exchangeOption(model, S1, S2, T) << "\n" << std::setprecision(3);
+
+    for (int t : threads) {
+        std::unique_ptr<ThreadPool> pool;
+        if (t > 1) pool = std::make_unique<ThreadPool>(t);
+        AdiFdSolver solver;
+        solver.setThreadPool(pool.get());
+
+        AdiFdSolver::Result res;
+        const double seconds = timeIt([&] { res = solver.price(exchange, model, grid, S1, S2); });
+        std::cout << "threads " << t << " : " << seconds << " s  " << updates / seconds * 1e-6 << " Mnodes/s  "
+                  << "speed-up x" << tSerial / seconds
+                  << "  identical=" << (res.V0 == reference.V0 ? "yes" : "NO") << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Stress run: an American put under `count` (sigma, r) shocks, serial,
+// median of 3 runs.
+// One solve per scenario on its own GridParameters grid, against the lane
+// engine on one shared grid and on one grid per pass (bucketed).
+// ---------------------------------------------------------------------------
+static void benchScenarios(int count, double rel_dS) {
+    const double S0 = 100.0, K = 100.0, T = 1.0;
+    const BlackScholesModel base(0.05, 0.2, 0.02);
+
+    const std::vector<double> rateShifts{-0.01, 0.0, 0.01, 0.02};
+    const int nVol = std::max(1, (count + 3) / 4);
+    std::vector<double> volShifts;
+    for (int k = 0; k < nVol; ++k) volShifts.push_back(nVol > 1 ? -0.1 + 0.3 * k / (nVol - 1) : 0.0);
+    const auto scenarios = ScenarioPricer::shocked(base, volShifts, rateShifts, {0.0});
+    const int M = static_cast<int>(scenarios.size());
+
+    const ExplicitFdSolver solver;
+    std::vector<double> loopPrices(M);
+    const double tLoop = medianTime([&] {
+        for (int k = 0; k < M; ++k) {
+            AmericanPut put(K, T, scenarios[k]);
+            const FdGrid grid = GridParameters::makeGrid(put, scenarios[k], S0, rel_dS);
+            loopPrices[k] = solver.price(put, scenarios[k], grid, S0).price;
+        }
+    }, 3, 0.0);
+
+    const ScenarioPricer engine;
+    AmericanPut put(K, T, base);
+    ScenarioPricer::Result shared, bucketed;
+    FdGrid sharedGrid = ScenarioPricer::makeGrid(put, scenarios, S0, rel_dS);
+    const double tShared = medianTime([&] {
+        sharedGrid = ScenarioPricer::makeGrid(put, scenarios, S0, rel_dS);
+        shared = engine.price(ProductType::AmericanPut, K, 0.0, T, scenarios, sharedGrid, S0);
+    }, 3, 0.0);
+    const double tBucketed = medianTime([&] {
+        bucketed = engine.price(ProductType::AmericanPut, K, 0.0, T, scenarios, S0, rel_dS);
+    }, 3, 0.0);
+
+    double devShared = 0.0, devBucketed = 0.0;
+    for (int k = 0; k < M; ++k) {
+        devShared = std::max(devShared, std::fabs(shared.price(k) - loopPrices[k]));
+        devBucketed = std::max(devBucketed, std::fabs(bucketed.price(k) - loopPrices[k]));
+    }
+
+    std::cout << "=== Stress scenarios (American put, " << M << " shocks, rel_dS=" << rel_dS
+              << ", shared grid " << sharedGrid.Ns() + 1 << " x " << sharedGrid.Nt() << ", SIMD="
+              << stencil::name(stencil::detectSimdLevel()) << ") ===\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "per-scenario loop : " << tLoop << " s\n";
+    std::cout << "engine, shared    : " << tShared << " s  speed-up x" << tLoop / tShared
+              << std::scientific << std::setprecision(1) << "  max |price - loop| " << devShared << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "engine, bucketed  : " << tBucketed << " s  speed-up x" << tLoop / tBucketed
+              << std::scientific << std::setprecision(1) << "  max |price - loop| " << devBucketed << "\n";
+}
+
+// Comma-separated list of numbers
+template <class T>
+static std::vector<T> parseList(const char* text) {
+    std::vector<T> out;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(static_cast<T>(std::atof(item.c_str())));
+    }
+    return out;
+}
+
+static void usage() {
+    std::cerr << "Usage: bs_bench [--json] [--out FILE] [--products a,b] [--rel-ds x,y] [--threads n,m] [--min-time s]\n"
+              << "       bs_bench --blocking [Ns] [Nt] [depth] [width]\n"
+              << "       bs_bench --adi [rel_dS] [threads n,m]\n"
+              << "       bs_bench --scenarios [count] [rel_dS]\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && !std::strcmp(argv[1], "--blocking")) {
+        // bs_bench --blocking [Ns] [Nt] [depth] [width]
+        const int Ns    = argc > 2 ? std::atoi(argv[2]) : 4000000;
+        const int Nt    = argc > 3 ? std::atoi(argv[3]) : 64;
+        const int depth = argc > 4 ? std::atoi(argv[4]) : 16;
+        const int width = argc > 5 ? std::atoi(argv[5]) : 4096;
+        benchTemporalBlocking(Ns, Nt, depth, width);
+        return 0;
+    }
+    if (argc > 1 && !std::strcmp(argv[1], "--adi")) {
+        // bs_bench --adi [rel_dS] [threads n,m]
+        const double rel = argc > 2 ? std::atof(argv[2]) : 0.005;
+        std::vector<int> threads{1};
+        if (argc > 3) {
+            threads = parseList<int>(argv[3]);
+        } else {
+            const int hw = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+            for (int t = 2; t <= hw; t *= 2) threads.push_back(t);
+            if (threads.back() != hw) threads.push_back(hw);
+        }
+        benchAdi(rel, threads);
+        return 0;
+    }
+
+    if (argc > 1 && !std::strcmp(argv[1], "--scenarios")) {
+        // bs_bench --scenarios [count] [rel_dS]
+        const int count  = argc > 2 ? std::atoi(argv[2]) : 64;
+        const double rel = argc > 3 ? std::atof(argv[3]) : 0.01;
+        benchScenarios(count, rel);
+        return 0;
+    }
+
+    bool json = false;
+    std::string outPath;
+    std::vector<ProductType> products = {ProductType::EuropeanCall, ProductType::AmericanPut,
+                                         ProductType::BullCallSpread, ProductType::Straddle};
+    std::vector<double> relDs = {0.008, 0.004, 0.002};
+    std::vector<int> threads;
+    const int hw = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int t = 1; t < hw; t *= 2) threads.push_back(t);
+    threads.push_back(hw);
+    double minSeconds = 0.2;
+
+    try {
+        for (int a = 1; a < argc; ++a) {
+            const bool hasValue = a + 1 < argc;
+            if (!std::strcmp(argv[a], "--json")) {
+                json = true;
+            } else if (!std::strcmp(argv[a], "--out") && hasValue) {
+                outPath = argv[++a];
+            } else if (!std::strcmp(argv[a], "--products") && hasValue) {
+                products.clear();
+                std::stringstream ss(argv[++a]);
+                std::string item;
+                while (std::getline(ss, item, ',')) products.push_back(ProductFactory::parse(item));
+            } else if (!std::strcmp(argv[a], "--rel-ds") && hasValue) {
+                relDs = parseList<double>(argv[++a]);
+            } else if (!std::strcmp(argv[a], "--threads") && hasValue) {
+                threads = parseList<int>(argv[++a]);
+            } else if (!std::strcmp(argv[a], "--min-time") && hasValue) {
+                minSeconds = std::atof(argv[++a]);
+            } else {
+                usage();
+                return 1;
+            }
+        }
+
+        std::vector<SweepPoint> points;
+        for (int t : threads) {
+            std::unique_ptr<ThreadPool> pool;
+            if (t > 1) pool = std::make_unique<ThreadPool>(t);
+            for (ProductType type : products) {
+                for (double rel : relDs) points.push_back(benchPoint(type, rel, pool.get(), minSeconds));
+            }
+        }
+
+        std::ofstream file;
+        if (!outPath.empty()) {
+            file.open(outPath);
+            if (!file) throw std::runtime_error("Cannot open " + outPath);
+        }
+        std::ostream& out = outPath.empty() ? std::cout : file;
+        if (json) writeJson(out, points);
+        else      writeTable(out, points);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
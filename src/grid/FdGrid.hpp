@@ -2,12 +2,24 @@
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <cmath>
+#include <utility>
 
 /**
  * Finite-difference grid in time and asset price
+ * The time grid is uniform and is not materialized: t_n = n * dt.
+ * The price grid is either uniform or an arbitrary increasing set of nodes,
+ * typically stretched around the strikes (see clustered()).
  */
 class FdGrid {
 public:
+    // Three-point weights of dV/dS and d2V/dS2 at an interior node:
+    // V' ~ d1m V[i-1] + d1c V[i] + d1p V[i+1], same for V'' with d2*
+    struct Weights {
+        double d1m, d1c, d1p;
+        double d2m, d2c, d2p;
+    };
+
     FdGrid(double T, double Smax, int NbTimeSteps, int NbPriceSteps, double Smin = 0.0)
         : T_(T), Smin_(Smin), Smax_(Smax), Nt_(NbTimeSteps), Ns_(NbPriceSteps)
     {
@@ -21,28 +33,164 @@ public:
         dt_ = T_ / Nt_;
         dS_ = (Smax_ - Smin_) / Ns_;
 
-        // Time grid
-        t_.resize(Nt_ + 1);
-        for (int n = 0; n <= Nt_; ++n)
-            t_[n] = n * dt_;
-
         // Price grid
         S_.resize(Ns_ + 1);
         for (int i = 0; i <= Ns_; ++i)
             S_[i] = Smin_ + i * dS_;
     }
 
+    // Non-uniform price grid on the given nodes (strictly increasing)
+    FdGrid(double T, int NbTimeSteps, std::vector<double> priceNodes)
+        : T_(T), Nt_(NbTimeSteps), Ns_(static_cast<int>(priceNodes.size()) - 1),
+          uniform_(false), S_(std::move(priceNodes))
+    {
+        if (T_ <= 0.0)
+            throw std::invalid_argument("T must be > 0");
+        if (Nt_ <= 0 || Ns_ <= 1)
+            throw std::invalid_argument("Nt > 0 and Ns > 1 required");
+
+        dS_ = S_[1] - S_[0];
+        for (int i = 0; i < Ns_; ++i) {
+            if (!(S_[i + 1] > S_[i]))
+                throw std::invalid_argument("Price nodes must be strictly increasing");
+            dS_ = std::min(dS_, S_[i + 1] - S_[i]);
+        }
+
+        Smin_ = S_.front();
+        Smax_ = S_.back();
+        dt_ = T_ / Nt_;
+    }
+
+    // sinh-stretched grid concentrated around the given centers (strikes).
+    // Nodes are equally spaced in F(S) = sum_k asinh((S - c_k) / width):
+    // near an isolated center the step is about width * (F(Smax) - F(Smin)) / Ns,
+    // and it grows linearly with the distance to the centers.
+    static FdGrid clustered(double T, double Smin, double Smax,
+                            int NbTimeSteps, int NbPriceSteps,
+                            const std::vector<double>& centers, double width)
+    {
+        if (Smax <= Smin)
+            throw std::invalid_argument("Smax must be > Smin");
+        if (NbPriceSteps <= 1)
+            throw std::invalid_argument("Nt > 0 and Ns > 1 required");
+        if (centers.empty() || width <= 0.0)
+            throw std::invalid_argument("Clustered grid needs centers and width > 0");
+
+        auto F = [&](double x) {
+            double f = 0.0;
+            for (double c : centers) f += std::asinh((x - c) / width);
+            return f;
+        };
+        auto dF = [&](double x) {
+            double f = 0.0;
+            for (double c : centers) {
+                const double u = (x - c) / width;
+                f += 1.0 / (width * std::sqrt(1.0 + u * u));
+            }
+            return f;
+        };
+
+        const double F0 = F(Smin);
+        const double F1 = F(Smax);
+
+        std::vector<double> S(NbPriceSteps + 1);
+        S.front() = Smin;
+        S.back()  = Smax;
+
+        // F is increasing: safeguarded Newton on each node, warm-started
+        // from the previous one
+        double lo = Smin;
+        for (int i = 1; i < NbPriceSteps; ++i) {
+            const double target = F0 + (F1 - F0) * i / NbPriceSteps;
+            double a = lo, b = Smax, x = lo;
+            for (int it = 0; it < 100; ++it) {
+                const double g = F(x) - target;
+                if (g < 0.0) a = x; else b = x;
+                double xn = x - g / dF(x);
+                if (!(xn > a && xn < b)) xn = 0.5 * (a + b);
+                if (std::fabs(xn - x) <= 1e-14 * (std::fabs(x) + width)) { x = xn; break; }
+                x = xn;
+            }
+            S[i] = x;
+            lo = x;
+        }
+
+        return FdGrid(T, NbTimeSteps, std::move(S));
+    }
+
+    // Price nodes S_i = exp(x_min + i dx), uniform in x = ln S (LogFdSolver).
+    // If anchor lies on a node up to rounding, that node is set to it exactly.
+    static FdGrid logUniform(double T, double Smin, double Smax, int NbTimeSteps, int NbPriceSteps,
+                             double anchor = 0.0)
+    {
+        if (Smin <= 0.0 || Smax <= Smin)
+            throw std::invalid_argument("Log-uniform grid needs 0 < Smin < Smax");
+        if (NbPriceSteps <= 1)
+            throw std::invalid_argument("Nt > 0 and Ns > 1 required");
+
+        const double xmin = std::log(Smin);
+        const double dx = (std::log(Smax) - xmin) / NbPriceSteps;
+
+        std::vector<double> S(NbPriceSteps + 1);
+        for (int i = 0; i <= NbPriceSteps; ++i)
+            S[i] = std::exp(xmin + i * dx);
+        S.front() = Smin;
+        S.back()  = Smax;
+
+        if (anchor > Smin && anchor < Smax) {
+            const double k = (std::log(anchor) - xmin) / dx;
+            const long i = std::lround(k);
+            if (std::fabs(k - i) < 1e-6 && i > 0 && i < NbPriceSteps)
+                S[i] = anchor;
+        }
+
+        FdGrid grid(T, NbTimeSteps, std::move(S));
+        grid.dx_ = dx;
+        return grid;
+    }
+
     // --- getters ---
     double T() const  { return T_; }
     double dt() const { return dt_; }
-    double dS() const { return dS_; }
+    double dS() const { return dS_; }   // uniform step, smallest step if non-uniform
+
+    bool uniform() const { return uniform_; }
+
+    bool logUniform() const { return dx_ > 0.0; }
+    double dx() const { return dx_; }   // step in ln S, 0 unless logUniform()
 
     int Nt() const { return Nt_; }
     int Ns() const { return Ns_; }
 
-    const std::vector<double>& timeGrid() const  { return t_; }
+    // Time level n, n = 0..Nt
+    double time(int n) const { return n * dt_; }
+
+    // Materialized time grid (allocates; solvers use time(n))
+    std::vector<double> timeGrid() const {
+        std::vector<double> t(Nt_ + 1);
+        for (int n = 0; n <= Nt_; ++n)
+            t[n] = time(n);
+        return t;
+    }
+
     const std::vector<double>& priceGrid() const { return S_; }
 
+    // Derivative weights at interior node i, second order on any spacing
+    Weights weights(int i) const {
+        const double hm = S_[i] - S_[i - 1];
+        const double hp = S_[i + 1] - S_[i];
+        const double hs = hm + hp;
+
+        Weights w;
+        w.d1m = -hp / (hm * hs);
+        w.d1c = (hp - hm) / (hm * hp);
+        w.d1p = hm / (hp * hs);
+        w.d2m = 2.0 / (hm * hs);
+        w.d2c = -2.0 / (hm * hp);
+        w.d2p = 2.0 / (hp * hs);
+        return w;
+    }
+
     // Linear interpolation of a value defined on the S-grid
     double interpolate(const std::vector<double>& V, double S0) const {
         if ((int)V.size() != Ns_ + 1)
@@ -54,7 +202,7 @@ public:
         auto it = std::upper_bound(S_.begin(), S_.end(), S0);
         int i = static_cast<int>(it - S_.begin()) - 1;
 
-        const double denom = (S_[i+1] - S_[i]); // should be dS_, but keep generic
+        const double denom = (S_[i+1] - S_[i]);
         const double w = (S0 - S_[i]) / denom;
 
         return (1.0 - w) * V[i] + w * V[i+1];
@@ -69,7 +217,8 @@ private:
 
     double dt_;
     double dS_;
+    bool uniform_ = true;
+    double dx_ = 0.0;
 
-    std::vector<double> t_;
     std::vector<double> S_;
 };
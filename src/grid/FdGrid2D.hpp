@@ -0,0 +1,47 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include "FdGrid.hpp"
+
+/**
+ * Finite-difference grid in time and two asset prices
+ * The price grid is the tensor product of two FdGrid axes (uniform or
+ * stretched), which share the maturity and the uniform time grid.
+ * Values are stored row-major with asset 1 contiguous:
+ * node (i, j) = (S1_i, S2_j) is at index(i, j) = j * (N1 + 1) + i.
+ */
+class FdGrid2D {
+public:
+    FdGrid2D(FdGrid axis1, FdGrid axis2)
+        : axis1_(std::move(axis1)), axis2_(std::move(axis2))
+    {
+        if (axis1_.Nt() != axis2_.Nt() || std::fabs(axis1_.T() - axis2_.T()) > 1e-12 * axis1_.T())
+            throw std::invalid_argument("Both axes of a 2D grid must share T and Nt.");
+    }
+
+    double T() const  { return axis1_.T(); }
+    double dt() const { return axis1_.dt(); }
+    int Nt() const    { return axis1_.Nt(); }
+
+    // Time level n, n = 0..Nt
+    double time(int n) const { return axis1_.time(n); }
+
+    const FdGrid& axis1() const { return axis1_; }
+    const FdGrid& axis2() const { return axis2_; }
+
+    int N1() const { return axis1_.Ns(); }   // price steps per axis
+    int N2() const { return axis2_.Ns(); }
+
+    std::size_t size() const {
+        return static_cast<std::size_t>(N1() + 1) * static_cast<std::size_t>(N2() + 1);
+    }
+    std::size_t index(int i, int j) const {
+        return static_cast<std::size_t>(j) * static_cast<std::size_t>(N1() + 1) + static_cast<std::size_t>(i);
+    }
+
+private:
+    FdGrid axis1_;
+    FdGrid axis2_;
+};
@@ -1,13 +1,23 @@
 #pragma once
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <vector>
 #include "FdGrid.hpp"
+#include "FdGrid2D.hpp"
+#include "TermStructureGrid.hpp"
 #include "../model/BlackScholesModel.hpp"
+#include "../model/TermStructureModel.hpp"
+#include "../model/TwoAssetModel.hpp"
 #include "../products/InterfaceProducts.hpp"
+#include "../products/InterfaceTwoAssetProducts.hpp"
 
 class GridParameters {
 public:
     // Explicit scheme grid builder
     // rel_dS: spatial step as a fraction of S0 (e.g. 0.002 = 0.2%)
+    // Knock-out products: the domain ends on continuously monitored
+    // barriers, and a discretely monitored barrier is a node.
     static FdGrid makeGrid(const InterfaceProducts& product,
                            const BlackScholesModel& model,
                            double S0,
@@ -16,20 +26,13 @@ public:
     {
         const double T   = product.maturity();
         const double r   = model.r();
-        const double q   = model.q();
         const double sig = model.sigma();
 
-        // 1) Spatial domain: high lognormal quantile
-        const double z = 5.0;
-        const double drift   = (r - q - 0.5 * sig * sig) * T;
-        const double volTerm = z * sig * std::sqrt(T);
-
-        const double Smax = S0 * std::exp(drift + volTerm);
-
+        // 1) Spatial domain: high lognormal quantile (or barriers)
         // 2) Spatial resolution: relative to S0
-        const double dS = rel_dS * S0;
-
-        const int Ns = static_cast<int>(std::ceil((Smax - Smin) / dS));
+        const UniformDomain d = uniformDomain(product, model, S0, rel_dS * S0, Smin);
+        const double Smax = d.Smax;
+        const double dS = d.dS;
 
         // 3) Time step from explicit stability (worst case at Smax)
         const double denom =
@@ -38,6 +41,314 @@ public:
         const double dt = 0.45 / denom;
         const int Nt = static_cast<int>(std::ceil(T / dt));
 
-        return FdGrid(T, Smax, Nt, Ns, Smin);
+        return FdGrid(T, Smax, Nt, d.Ns, d.Smin);
+    }
+
+    // Explicit grid for a term-structure model: S-domain of the equivalent
+    // constant model on [0, T] (same forward and total variance), time
+    // steps aligned on the segment boundaries (and barrier monitoring
+    // dates) and dt from the explicit stability of the most demanding
+    // segment before T
+    static TermStructureGrid makeGrid(const InterfaceProducts& product,
+                                      const TermStructureModel& model,
+                                      double S0,
+                                      double rel_dS,
+                                      double Smin = 0.0)
+    {
+        const double T = product.maturity();
+
+        const UniformDomain d = uniformDomain(product, model.average(0.0, T), S0, rel_dS * S0, Smin);
+        const double Smax = d.Smax;
+        const double dS = d.dS;
+
+        double denom = 0.0;
+        for (int k = 0; k < model.segmentCount() && model.segment(k).start < T; ++k) {
+            const double sig = model.segment(k).sigma;
+            denom = std::max(denom, (sig * sig * Smax * Smax) / (dS * dS) + model.segment(k).r);
+        }
+
+        return TermStructureGrid(FdGrid(T, Smax, 1, d.Ns, d.Smin), model, 0.45 / denom,
+                                 product.monitoringDates());
+    }
+
+    // Implicit / Crank–Nicolson grid builder (ThetaFdSolver)
+    // Same spatial domain as makeGrid, but Nt is chosen from accuracy:
+    // dt is matched to dS so that the O(dt^2) time error of Crank–Nicolson
+    // stays of the order of the O(dS^2) space error.
+    static FdGrid makeImplicitGrid(const InterfaceProducts& product,
+                                   const BlackScholesModel& model,
+                                   double S0,
+                                   double rel_dS,
+                                   double Smin = 0.0,
+                                   int minTimeSteps = 25)
+    {
+        const double T   = product.maturity();
+        const double sig = model.sigma();
+
+        const UniformDomain d = uniformDomain(product, model, S0, rel_dS * S0, Smin);
+
+        // Total volatility over the life of the trade, measured in grid steps
+        const int Nt = std::max(minTimeSteps,
+                                static_cast<int>(std::ceil(sig * std::sqrt(T) / rel_dS)));
+
+        return FdGrid(T, d.Smax, Nt, d.Ns, d.Smin);
+    }
+
+    // Strike-clustered grids (sinh-stretched, see FdGrid::clustered)
+    // rel_dS: spatial step at the strikes and at S0 as a fraction of S0;
+    // the step grows away from them, so far fewer nodes are needed than
+    // with a uniform grid of the same resolution around the kinks.
+    static FdGrid makeClusteredGrid(const InterfaceProducts& product,
+                                    const BlackScholesModel& model,
+                                    double S0,
+                                    double rel_dS,
+                                    double Smin = 0.0)
+    {
+        const double T   = product.maturity();
+        const double r   = model.r();
+        const double sig = model.sigma();
+
+        const UniformDomain d = uniformDomain(product, model, S0, rel_dS * S0, Smin);
+        const std::vector<double> S = clusteredNodes(product, model, d.Smax, S0, rel_dS, d.Smin);
+        const int Ns = static_cast<int>(S.size()) - 1;
+
+        // Explicit stability, worst interior node: sigma^2 S^2 / (h- h+) + r
+        double denom = 0.0;
+        for (int i = 1; i < Ns; ++i) {
+            const double h2 = (S[i] - S[i - 1]) * (S[i + 1] - S[i]);
+            denom = std::max(denom, sig * sig * S[i] * S[i] / h2 + r);
+        }
+
+        const double dt = 0.45 / denom;
+        const int Nt = static_cast<int>(std::ceil(T / dt));
+
+        return FdGrid(T, Nt, S);
+    }
+
+    // Strike-clustered grid for ThetaFdSolver: Nt chosen as in makeImplicitGrid
+    static FdGrid makeClusteredImplicitGrid(const InterfaceProducts& product,
+                                            const BlackScholesModel& model,
+                                            double S0,
+                                            double rel_dS,
+                                            double Smin = 0.0,
+                                            int minTimeSteps = 25)
+    {
+        const double T   = product.maturity();
+        const double sig = model.sigma();
+
+        const int Nt = std::max(minTimeSteps,
+                                static_cast<int>(std::ceil(sig * std::sqrt(T) / rel_dS)));
+
+        const UniformDomain d = uniformDomain(product, model, S0, rel_dS * S0, Smin);
+        return FdGrid(T, Nt, clusteredNodes(product, model, d.Smax, S0, rel_dS, d.Smin));
+    }
+
+    // Log-price grid for LogFdSolver: uniform in x = ln S with dx = rel_dS
+    // (the same resolution as makeGrid around S0), from the low to the high
+    // lognormal quantile, shifted so that the strike is a node. The explicit
+    // limit dt <= dx^2 / sigma^2 does not depend on Smax.
+    static FdGrid makeLogGrid(const InterfaceProducts& product,
+                              const BlackScholesModel& model,
+                              double S0,
+                              double rel_dS)
+    {
+        const double T   = product.maturity();
+        const double r   = model.r();
+        const double sig = model.sigma();
+
+        double dx = rel_dS;
+        double xmax = std::log(upperBound(product, model, S0));
+        double xmin = std::log(lowerBound(product, model, S0));
+
+        // Continuously monitored barriers are the domain ends; with one
+        // barrier, dx shrinks so that the strike stays a node
+        const bool upper = product.continuousBarrier() && std::isfinite(product.upperBarrier());
+        const bool lower = product.continuousBarrier() && product.lowerBarrier() > 0.0;
+        if (upper) xmax = std::log(product.upperBarrier());
+        if (lower) xmin = std::log(product.lowerBarrier());
+        if (!(xmax > xmin)) throw std::invalid_argument("Barrier leaves an empty S-domain.");
+
+        const double K = product.strike();
+        if (K > 0.0 && std::log(K) > xmin && std::log(K) < xmax && !(upper && lower)) {
+            const double xK = std::log(K);
+            if (upper) {
+                dx = (xmax - xK) / std::ceil((xmax - xK) / dx - 1e-9);
+                xmin = xmax - std::ceil((xmax - xmin) / dx - 1e-9) * dx;
+            } else if (lower) {
+                dx = (xK - xmin) / std::ceil((xK - xmin) / dx - 1e-9);
+            } else {
+                xmin = xK - std::ceil((xK - xmin) / dx) * dx;
+            }
+        }
+
+        const int Ns = std::max(2, static_cast<int>(std::ceil((xmax - xmin) / dx - 1e-9)));
+        if (upper && lower) dx = (xmax - xmin) / Ns;
+        if (upper) xmin = xmax - Ns * dx;
+
+        const double dt = 0.45 / (sig * sig / (dx * dx) + r);
+        const int Nt = static_cast<int>(std::ceil(T / dt));
+
+        return FdGrid::logUniform(T, lower ? product.lowerBarrier() : std::exp(xmin),
+                                  upper ? product.upperBarrier() : std::exp(xmin + Ns * dx), Nt, Ns, K);
+    }
+
+    // Two-asset grid for AdiFdSolver: each axis uniform on [0, high
+    // lognormal quantile of its asset], with step rel_dS * S0 of that asset;
+    // Nt chosen as in makeImplicitGrid from the larger volatility
+    static FdGrid2D makeGrid(const InterfaceTwoAssetProducts& product,
+                             const TwoAssetModel& model,
+                             double S1,
+                             double S2,
+                             double rel_dS,
+                             int minTimeSteps = 25)
+    {
+        const double T   = product.maturity();
+        const double sig = std::max(model.sigma1(), model.sigma2());
+
+        const int Nt = std::max(minTimeSteps,
+                                static_cast<int>(std::ceil(sig * std::sqrt(T) / rel_dS)));
+
+        auto axis = [&](const BlackScholesModel& asset, double S0) {
+            const double Smax = upperQuantile(asset, S0, T);
+            const int Ns = std::max(2, static_cast<int>(std::ceil(Smax / (rel_dS * S0))));
+            return FdGrid(T, Smax, Nt, Ns);
+        };
+        return FdGrid2D(axis(model.asset(1), S1), axis(model.asset(2), S2));
+    }
+
+    // Uniform S-domain [Smin, Smin + Ns dS] with step dS at most the
+    // requested one
+    struct UniformDomain {
+        double Smin;
+        double Smax;
+        double dS;
+        int Ns;
+    };
+
+    // High lognormal quantile above Smin, ended on continuously monitored
+    // barriers; a discretely monitored barrier inside it is moved onto a
+    // node (dS shrinks to divide B - Smin), so that knock-outs on the
+    // monitoring dates hit exactly the nodes at or beyond it
+    static UniformDomain uniformDomain(const InterfaceProducts& product,
+                                       const BlackScholesModel& model,
+                                       double S0,
+                                       double dS,
+                                       double Smin)
+    {
+        double Smax = upperBound(product, model, S0);
+        const double L = product.lowerBarrier();
+        const double H = product.upperBarrier();
+
+        if (product.continuousBarrier()) {
+            if (std::isfinite(H)) Smax = H;
+            if (L > 0.0) Smin = std::max(Smin, L);
+            if (!(Smax > Smin)) throw std::invalid_argument("Barrier leaves an empty S-domain.");
+
+            const int Ns = std::max(2, static_cast<int>(std::ceil((Smax - Smin) / dS - 1e-9)));
+            return {Smin, Smax, (Smax - Smin) / Ns, Ns};
+        }
+
+        const double B = (H > Smin && H < Smax) ? H : (L > Smin && L < Smax) ? L : 0.0;
+        if (B > 0.0) {
+            const double h = (B - Smin) / std::ceil((B - Smin) / dS - 1e-9);
+            const int Ns = static_cast<int>(std::ceil((Smax - Smin) / h - 1e-9));
+            return {Smin, Smin + Ns * h, h, Ns};
+        }
+
+        return {Smin, Smax, dS, static_cast<int>(std::ceil((Smax - Smin) / dS))};
+    }
+
+private:
+    // Width of the stretched region around each center, in units of the
+    // terminal standard deviation S0 * sigma * sqrt(T)
+    static constexpr double kClusterWidth = 0.5;
+
+    // Step at the centers relative to rel_dS * S0: the coarse far field costs
+    // accuracy, so the centers are resolved more finely than on the uniform
+    // grid to keep the price error of the same order
+    static constexpr double kCenterStep = 0.5;
+
+    // sinh-stretched nodes around the product strikes and the spot, with
+    // Ns chosen so that the step at every center is at most rel_dS * S0
+    static std::vector<double> clusteredNodes(const InterfaceProducts& product,
+                                              const BlackScholesModel& model,
+                                              double Smax,
+                                              double S0,
+                                              double rel_dS,
+                                              double Smin)
+    {
+        std::vector<double> centers = product.strikes();
+        centers.push_back(S0);
+
+        const double width = kClusterWidth * model.sigma() * std::sqrt(product.maturity()) * S0;
+        const double h = kCenterStep * rel_dS * S0;
+
+        // Local step at x for Ns nodes: (F(Smax) - F(Smin)) / (Ns F'(x))
+        double span = 0.0;
+        double minSlope = 0.0;
+        for (double c : centers) {
+            span += std::asinh((Smax - c) / width) - std::asinh((Smin - c) / width);
+        }
+        for (std::size_t k = 0; k < centers.size(); ++k) {
+            double slope = 0.0;
+            for (double c : centers) {
+                const double u = (centers[k] - c) / width;
+                slope += 1.0 / (width * std::sqrt(1.0 + u * u));
+            }
+            minSlope = (k == 0) ? slope : std::min(minSlope, slope);
+        }
+
+        const int Ns = std::max(2, static_cast<int>(std::ceil(span / (minSlope * h))));
+
+        // Nt is irrelevant here: only the price nodes are kept
+        std::vector<double> S =
+            FdGrid::clustered(product.maturity(), Smin, Smax, 1, Ns, centers, width).priceGrid();
+
+        // Move the nearest interior node onto each center, so that the payoff
+        // kinks and the spot sit on the grid as they do on a uniform grid
+        for (double c : centers) {
+            auto it = std::lower_bound(S.begin() + 1, S.end() - 1, c);
+            if (it == S.end() - 1 || (it != S.begin() + 1 && c - *(it - 1) < *it - c)) --it;
+            if (it > S.begin() && it < S.end() - 1 && c > *(it - 1) && c < *(it + 1)) *it = c;
+        }
+        return S;
+    }
+
+    // Upper end of the S-domain: high lognormal quantile of S_T
+    static double upperBound(const InterfaceProducts& product,
+                             const BlackScholesModel& model,
+                             double S0)
+    {
+        return upperQuantile(model, S0, product.maturity());
+    }
+
+    static double upperQuantile(const BlackScholesModel& model, double S0, double T)
+    {
+        const double r   = model.r();
+        const double q   = model.q();
+        const double sig = model.sigma();
+
+        const double z = 5.0;
+        const double drift   = (r - q - 0.5 * sig * sig) * T;
+        const double volTerm = z * sig * std::sqrt(T);
+
+        return S0 * std::exp(drift + volTerm);
+    }
+
+    // Lower end of a log-price domain: low lognormal quantile of S_T
+    static double lowerBound(const InterfaceProducts& product,
+                             const BlackScholesModel& model,
+                             double S0)
+    {
+        const double T   = product.maturity();
+        const double r   = model.r();
+        const double q   = model.q();
+        const double sig = model.sigma();
+
+        const double z = 5.0;
+        const double drift   = (r - q - 0.5 * sig * sig) * T;
+        const double volTerm = z * sig * std::sqrt(T);
+
+        return S0 * std::exp(drift - volTerm);
     }
 };
@@ -0,0 +1,66 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "FdGrid.hpp"
+#include "../model/TermStructureModel.hpp"
+
+/**
+ * Piecewise-uniform time grid for term-structure models
+ * [0, T] is cut at every segment start of the model (and at extra times
+ * such as barrier monitoring dates), so that segment boundaries are time
+ * levels; each piece is a uniform FdGrid on the same price nodes, with its
+ * own time origin (piece k covers [start(k), start(k) + piece(k).T()]) and
+ * at most maxDt per step.
+ */
+class TermStructureGrid {
+public:
+    // nodes: price nodes (and maturity T) shared by every piece
+    TermStructureGrid(const FdGrid& nodes, const TermStructureModel& model, double maxDt,
+                      const std::vector<double>& extraCuts = {})
+    {
+        if (!(maxDt > 0.0)) throw std::invalid_argument("maxDt must be > 0.");
+
+        const double T = nodes.T();
+        std::vector<double> cuts{0.0};
+        for (int k = 1; k < model.segmentCount(); ++k) {
+            const double t = model.segment(k).start;
+            if (t < T) cuts.push_back(t);
+        }
+        for (double t : extraCuts) {
+            if (t > 0.0 && t < T) cuts.push_back(t);
+        }
+        std::sort(cuts.begin(), cuts.end());
+        cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+        cuts.push_back(T);
+
+        for (std::size_t k = 0; k + 1 < cuts.size(); ++k) {
+            const double length = cuts[k + 1] - cuts[k];
+            const int steps = std::max(1, static_cast<int>(std::ceil(length / maxDt)));
+
+            starts_.push_back(cuts[k]);
+            pieces_.push_back(nodes.uniform()
+                ? FdGrid(length, nodes.priceGrid().back(), steps, nodes.Ns(), nodes.priceGrid().front())
+                : FdGrid(length, steps, nodes.priceGrid()));
+            Nt_ += steps;
+        }
+        T_ = T;
+    }
+
+    double T() const { return T_; }
+    int Ns() const { return pieces_.front().Ns(); }
+    int Nt() const { return Nt_; }                    // all pieces
+
+    int pieces() const { return static_cast<int>(pieces_.size()); }
+    const FdGrid& piece(int k) const { return pieces_[k]; }
+    double start(int k) const { return starts_[k]; }
+
+    const std::vector<double>& priceGrid() const { return pieces_.front().priceGrid(); }
+
+private:
+    std::vector<FdGrid> pieces_;
+    std::vector<double> starts_;
+    double T_ = 0.0;
+    int Nt_ = 0;
+};
@@ -5,6 +5,10 @@
 #include "grid/FdGrid.hpp"
 #include "grid/GridParameters.hpp"
 #include "solvers/ExplicitFdSolver.hpp"
+#include "solvers/ThetaFdSolver.hpp"
+#include "solvers/LogFdSolver.hpp"
+#include "solvers/AnalyticBsPricer.hpp"
+#include "solvers/AdaptivePricer.hpp"
 #include "products/InterfaceProducts.hpp"
 #include "products/EuropeanCall.hpp"
 #include "products/EuropeanPut.hpp"
@@ -14,6 +18,7 @@
 #include "products/BullCallSpread.hpp"
 #include "products/BearPutSpread.hpp"
 #include "products/Straddle.hpp"
+#include "products/BarrierOption.hpp"
 
 static void clear_input() {
     std::cin.clear();
@@ -50,10 +55,11 @@ static void print_menu() {
     std::cout << " 6) Bull Call Spread (Call(K1)-Call(K2), K1<K2)\n";
     std::cout << " 7) Bear Put Spread  (Put(K2)-Put(K1), K1<K2)\n";
     std::cout << " 8) Straddle (Call+Put)\n";
+    std::cout << " 9) Knock-out Call/Put (barrier above S0: up-and-out, below: down-and-out)\n";
 }
 
 int main() {
-    std::cout << "=== Black-Scholes PDE Pricer (FD Explicit) ===\n";
+    std::cout << "=== Black-Scholes PDE Pricer (Finite Differences) ===\n";
 
     // --- Market parameters ---
     const double S0    = read_double("Spot S0 (e.g 100): ", 0.0);
@@ -67,13 +73,28 @@ int main() {
     const double T = read_double("Maturity T (>0) (e.g 1): ", 1e-12);
 
     print_menu();
-    const int choice = read_int("Your choice (1-8): ", 1, 8);
+    const int choice = read_int("Your choice (1-9): ", 1, 9);
 
     // --- Grid resolution as percentage of S0 ---
     std::cout << "\nSpatial resolution (relative step):\n";
     std::cout << "Enter rel_dS such that dS = rel_dS * S0.\n";
     std::cout << "Typical values: 0.004 (fast), 0.002 (balanced), 0.001 (accurate)\n";
-    const double rel_dS = read_double("rel_dS (e.g 0.002): ", 1e-15);
+    std::cout << "Enter 0 to give a target price error instead.\n";
+    const double rel_dS = read_double("rel_dS (e.g 0.002): ", 0.0);
+
+    // --- Target error (adaptive) or time-stepping scheme ---
+    double targetError = 0.0;
+    int scheme = 2;
+    if (rel_dS == 0.0) {
+        targetError = read_double("Target absolute price error (e.g 1e-4): ", 1e-12);
+    } else {
+        std::cout << "\nScheme:\n";
+        std::cout << " 1) Explicit (Nt from stability)\n";
+        std::cout << " 2) Crank-Nicolson (Nt from accuracy)\n";
+        std::cout << " 3) Fully implicit (Nt from accuracy)\n";
+        std::cout << " 4) Explicit in log-price x = ln S (constant stencil)\n";
+        scheme = read_int("Your choice (1-4): ", 1, 4);
+    }
 
     // We must keep product objects alive after creation.
     std::unique_ptr<InterfaceProducts> product;
@@ -112,22 +133,76 @@ int main() {
     } else if (choice == 8) {
         const double K = read_double("Strike K (e.g 100): ", 0.0);
         product = std::make_unique<Straddle>(K, T, model);
+    } else if (choice == 9) {
+        const int kind = read_int("1) Call  2) Put: ", 1, 2);
+        const double K = read_double("Strike K (e.g 100): ", 0.0);
+        const double H = read_double("Barrier H (e.g 130): ", 1e-12);
+        const double R = read_double("Rebate paid at the barrier (e.g 0): ", 0.0);
+        if (H == S0) {
+            std::cerr << "Error: the barrier must differ from S0.\n";
+            return 1;
+        }
+        const bool up = H > S0;
+        const BarrierOption::Type type = (kind == 1)
+            ? (up ? BarrierOption::Type::UpAndOutCall : BarrierOption::Type::DownAndOutCall)
+            : (up ? BarrierOption::Type::UpAndOutPut : BarrierOption::Type::DownAndOutPut);
+        product = std::make_unique<BarrierOption>(type, K, H, T, model, R);
+    }
+
+    // --- Adaptive: refine until the Richardson error estimate meets the target ---
+    if (targetError > 0.0) {
+        AdaptivePricer::Config cfg;
+        cfg.absTol = targetError;
+        const auto out = AdaptivePricer(cfg).price(*product, model, S0);
+
+        std::cout << "\n=== Results (adaptive, Crank-Nicolson + Richardson) ===\n";
+        std::cout << "Price : " << out.result.price << "\n";
+        std::cout << "Delta : " << out.result.delta << "\n";
+        std::cout << "Gamma : " << out.result.gamma << "\n";
+        std::cout << "Error estimate: " << out.errorEstimate
+                  << (out.converged ? "" : " (target not reached at the finest level)") << "\n";
+        std::cout << "Grid: rel_dS=" << out.rel_dS << " Nt=" << out.Nt << " Ns=" << out.Ns
+                  << " (" << out.levels.size() << " levels, order " << out.order << ")\n";
+        std::cout << "Time: " << out.seconds * 1e3 << " ms\n";
+        std::cout << "\nDone.\n";
+        return 0;
     }
 
     // --- Grid auto (rel_dS controls Ns via dS = rel_dS*S0) ---
-    FdGrid grid = GridParameters::makeGrid(*product, model, S0, rel_dS);
+    FdGrid grid = (scheme == 1) ? GridParameters::makeGrid(*product, model, S0, rel_dS)
+                : (scheme == 4) ? GridParameters::makeLogGrid(*product, model, S0, rel_dS)
+                                : GridParameters::makeImplicitGrid(*product, model, S0, rel_dS);
 
     std::cout << "\nGrid: Nt=" << grid.Nt() << " Ns=" << grid.Ns()
               << " dt=" << grid.dt() << " dS=" << grid.dS() << "\n";
 
     // --- Price ---
-    ExplicitFdSolver solver;
-    const auto res = solver.price(*product, model, grid, S0);
+    ExplicitFdSolver::Result res;
+    if (scheme == 1) {
+        ExplicitFdSolver solver;
+        res = solver.price(*product, model, grid, S0);
+    } else if (scheme == 4) {
+        LogFdSolver solver;
+        res = solver.price(*product, model, grid, S0);
+    } else {
+        ThetaFdSolver solver(scheme == 2 ? 0.5 : 1.0);
+        res = solver.price(*product, model, grid, S0);
+    }
+
+    // --- Closed form when the product has one; the PDE result is kept as a check ---
+    const bool closedForm = AnalyticBsPricer::supports(*product);
+    const auto shown = closedForm ? AnalyticBsPricer().price(*product, model, S0) : res;
 
     std::cout << "\n=== Results ===\n";
-    std::cout << "Price : " << res.price << "\n";
-    std::cout << "Delta : " << res.delta << "\n";
-    std::cout << "Gamma : " << res.gamma << "\n";
+    std::cout << "Engine: " << (closedForm ? "closed form" : "PDE") << "\n";
+    std::cout << "Price : " << shown.price << "\n";
+    std::cout << "Delta : " << shown.delta << "\n";
+    std::cout << "Gamma : " << shown.gamma << "\n";
+
+    if (closedForm) {
+        std::cout << "\nPDE check: price=" << res.price << " delta=" << res.delta
+                  << " gamma=" << res.gamma << " (price error " << res.price - shown.price << ")\n";
+    }
 
     std::cout << "\nDone.\n";
     return 0;
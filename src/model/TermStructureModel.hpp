@@ -0,0 +1,143 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "BlackScholesModel.hpp"
+
+/**
+ * Black–Scholes model with piecewise-constant term structures
+ * r(t), sigma(t), q(t) on time segments [start_k, start_{k+1}); the first
+ * segment starts at t = 0 and the last one extends to infinity.
+ * Piecewise-linear curves are represented by constant sub-segments carrying
+ * the exact integrals of r, q and sigma^2 (piecewiseLinear()).
+ */
+
+class TermStructureModel {
+public:
+    struct Segment {
+        double start;   // segment applies on [start, next start)
+        double r;
+        double sigma;
+        double q;
+    };
+
+    // Segments sorted by start, the first one at t = 0
+    explicit TermStructureModel(std::vector<Segment> segments)
+        : segments_(std::move(segments))
+    {
+        if (segments_.empty() || segments_.front().start != 0.0)
+            throw std::invalid_argument("Term structure must start at t = 0.");
+        for (std::size_t k = 0; k < segments_.size(); ++k) {
+            if (segments_[k].sigma < 0.0)
+                throw std::invalid_argument("Volatility sigma must be non-negative.");
+            if (k > 0 && !(segments_[k].start > segments_[k - 1].start))
+                throw std::invalid_argument("Segment starts must be strictly increasing.");
+        }
+
+        // Integrals of r, q and sigma^2 up to each segment start
+        cumR_.assign(segments_.size(), 0.0);
+        cumQ_.assign(segments_.size(), 0.0);
+        cumVar_.assign(segments_.size(), 0.0);
+        for (std::size_t k = 1; k < segments_.size(); ++k) {
+            const Segment& s = segments_[k - 1];
+            const double h = segments_[k].start - s.start;
+            cumR_[k]   = cumR_[k - 1] + s.r * h;
+            cumQ_[k]   = cumQ_[k - 1] + s.q * h;
+            cumVar_[k] = cumVar_[k - 1] + s.sigma * s.sigma * h;
+        }
+    }
+
+    // Flat curves
+    explicit TermStructureModel(const BlackScholesModel& flat)
+        : TermStructureModel({Segment{0.0, flat.r(), flat.sigma(), flat.q()}}) {}
+
+    // Curves linear between knots (flat outside), each knot interval split
+    // into piecesPerInterval constant sub-segments: r and q take their mean
+    // on the sub-segment, sigma the root mean square, so discount factors,
+    // forwards and total variance are exact at every sub-segment boundary
+    static TermStructureModel piecewiseLinear(const std::vector<double>& times,
+                                              const std::vector<double>& r,
+                                              const std::vector<double>& sigma,
+                                              const std::vector<double>& q,
+                                              int piecesPerInterval = 4)
+    {
+        const std::size_t n = times.size();
+        if (n == 0 || r.size() != n || sigma.size() != n || q.size() != n)
+            throw std::invalid_argument("Curves need one r, sigma and q per knot.");
+        if (piecesPerInterval < 1) throw std::invalid_argument("piecesPerInterval must be >= 1.");
+        if (times.front() < 0.0) throw std::invalid_argument("Knot times must be >= 0.");
+
+        std::vector<Segment> segments;
+        if (times.front() > 0.0) segments.push_back({0.0, r.front(), sigma.front(), q.front()});
+
+        for (std::size_t j = 0; j + 1 < n; ++j) {
+            if (!(times[j + 1] > times[j])) throw std::invalid_argument("Knot times must be increasing.");
+            const double h = (times[j + 1] - times[j]) / piecesPerInterval;
+
+            for (int p = 0; p < piecesPerInterval; ++p) {
+                const double u0 = static_cast<double>(p) / piecesPerInterval;
+                const double u1 = static_cast<double>(p + 1) / piecesPerInterval;
+                auto lerp = [&](const std::vector<double>& y, double u) { return y[j] + (y[j + 1] - y[j]) * u; };
+
+                const double s0 = lerp(sigma, u0), s1 = lerp(sigma, u1);
+                segments.push_back({times[j] + p * h,
+                                    0.5 * (lerp(r, u0) + lerp(r, u1)),
+                                    std::sqrt((s0 * s0 + s0 * s1 + s1 * s1) / 3.0),
+                                    0.5 * (lerp(q, u0) + lerp(q, u1))});
+            }
+        }
+        if (segments.empty() || times.back() > segments.back().start)
+            segments.push_back({times.back(), r.back(), sigma.back(), q.back()});
+        return TermStructureModel(std::move(segments));
+    }
+
+    int segmentCount() const { return static_cast<int>(segments_.size()); }
+    const Segment& segment(int k) const { return segments_[k]; }
+
+    // Segment containing t (t >= 0)
+    int segmentIndex(double t) const {
+        const auto it = std::upper_bound(segments_.begin(), segments_.end(), t,
+                                         [](double x, const Segment& s) { return x < s.start; });
+        return std::max(0, static_cast<int>(it - segments_.begin()) - 1);
+    }
+
+    // Constant model in force at time t
+    BlackScholesModel at(double t) const {
+        const Segment& s = segments_[segmentIndex(t)];
+        return BlackScholesModel(s.r, s.sigma, s.q);
+    }
+
+    // Integrals from 0 to t of r, q and sigma^2
+    double rateIntegral(double t) const     { return integral(cumR_, t, &Segment::r); }
+    double dividendIntegral(double t) const { return integral(cumQ_, t, &Segment::q); }
+    double varianceIntegral(double t) const {
+        const int k = segmentIndex(t);
+        const Segment& s = segments_[k];
+        return cumVar_[k] + s.sigma * s.sigma * (t - s.start);
+    }
+
+    // Discount factor exp(-int_0^t r)
+    double discount(double t) const { return std::exp(-rateIntegral(t)); }
+
+    // Constant model equivalent on [t0, t1]: mean r and q, root mean square
+    // sigma (same discount factor, forward and total variance)
+    BlackScholesModel average(double t0, double t1) const {
+        if (!(t1 > t0)) return at(t0);
+        const double h = t1 - t0;
+        return BlackScholesModel((rateIntegral(t1) - rateIntegral(t0)) / h,
+                                 std::sqrt(std::max(0.0, varianceIntegral(t1) - varianceIntegral(t0)) / h),
+                                 (dividendIntegral(t1) - dividendIntegral(t0)) / h);
+    }
+
+private:
+    std::vector<Segment> segments_;
+    std::vector<double> cumR_, cumQ_, cumVar_;
+
+    double integral(const std::vector<double>& cum, double t, double Segment::*value) const {
+        const int k = segmentIndex(t);
+        const Segment& s = segments_[k];
+        return cum[k] + s.*value * (t - s.start);
+    }
+};
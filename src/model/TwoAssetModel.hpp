@@ -0,0 +1,49 @@
+#pragma once
+#include <cmath>
+#include <stdexcept>
+#include "BlackScholesModel.hpp"
+
+/**
+ * Two correlated Black–Scholes assets
+ * r              : risk-free rate
+ * sigma1, sigma2 : volatilities
+ * rho            : correlation of the two Brownian motions
+ * q1, q2         : continuous dividend yields
+ */
+class TwoAssetModel {
+public:
+    TwoAssetModel(double r, double sigma1, double sigma2, double rho, double q1 = 0.0, double q2 = 0.0)
+        : r_(r), sigma1_(sigma1), sigma2_(sigma2), rho_(rho), q1_(q1), q2_(q2)
+    {
+        if (sigma1_ < 0.0 || sigma2_ < 0.0)
+            throw std::invalid_argument("Volatilities must be non-negative.");
+        if (!(rho_ >= -1.0 && rho_ <= 1.0))
+            throw std::invalid_argument("Correlation rho must be in [-1, 1].");
+    }
+
+    double r() const      { return r_; }
+    double sigma1() const { return sigma1_; }
+    double sigma2() const { return sigma2_; }
+    double rho() const    { return rho_; }
+    double q1() const     { return q1_; }
+    double q2() const     { return q2_; }
+
+    // Marginal model of asset k (1 or 2)
+    BlackScholesModel asset(int k) const {
+        if (k != 1 && k != 2) throw std::invalid_argument("Asset index must be 1 or 2.");
+        return k == 1 ? BlackScholesModel(r_, sigma1_, q1_) : BlackScholesModel(r_, sigma2_, q2_);
+    }
+
+    // Discount factor exp(-r * t)
+    double discount(double t) const {
+        return std::exp(-r_ * t);
+    }
+
+private:
+    double r_;
+    double sigma1_;
+    double sigma2_;
+    double rho_;
+    double q1_;
+    double q2_;
+};
@@ -0,0 +1,157 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * Sense-reversing spin barrier for a fixed number of participants.
+ * Waiters spin briefly and then yield, so that oversubscribed hosts
+ * (more participants than cores) still make progress.
+ */
+class SpinBarrier {
+public:
+    explicit SpinBarrier(int participants)
+        : participants_(participants), remaining_(participants), generation_(0)
+    {
+        if (participants_ < 1)
+            throw std::invalid_argument("SpinBarrier needs at least one participant.");
+    }
+
+    void arriveAndWait() {
+        const unsigned gen = generation_.load(std::memory_order_acquire);
+
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            remaining_.store(participants_, std::memory_order_relaxed);
+            generation_.fetch_add(1, std::memory_order_acq_rel);
+            return;
+        }
+
+        int spins = 0;
+        while (generation_.load(std::memory_order_acquire) == gen) {
+            if (++spins > 256) std::this_thread::yield();
+        }
+    }
+
+private:
+    const int participants_;
+    std::atomic<int> remaining_;
+    std::atomic<unsigned> generation_;
+};
+
+/**
+ * Persistent pool of worker threads.
+ * Threads are created once; run() hands the same job to every participant
+ * (the nThreads-1 workers plus the calling thread, which is participant 0)
+ * and returns when all of them are done.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(int nThreads = static_cast<int>(std::thread::hardware_concurrency()))
+        : size_(std::max(1, nThreads))
+    {
+        workers_.reserve(size_ - 1);
+        for (int w = 1; w < size_; ++w) {
+            workers_.emplace_back([this, w] { workerLoop(w); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& th : workers_) th.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Number of participants (workers + calling thread)
+    int size() const { return size_; }
+
+    // Runs job(participant) on every participant, participant in [0, size()).
+    // Calls are serialized: one job at a time per pool. The first exception
+    // thrown by a participant is rethrown to the caller.
+    void run(const std::function<void(int)>& job) {
+        std::lock_guard<std::mutex> serial(runMutex_);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            pending_ = size_ - 1;
+            error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        execute(job, 0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        job_ = nullptr;
+
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    // Dynamic loop over [0, n): body(task, participant), tasks handed out
+    // one at a time so uneven tasks balance across participants
+    void parallelFor(int n, const std::function<void(int, int)>& body) {
+        std::atomic<int> next(0);
+        run([&](int participant) {
+            for (int task = next.fetch_add(1); task < n; task = next.fetch_add(1)) {
+                body(task, participant);
+            }
+        });
+    }
+
+private:
+    void workerLoop(int participant) {
+        unsigned seen = 0;
+        while (true) {
+            const std::function<void(int)>* job = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                job = job_;
+            }
+
+            execute(*job, participant);
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    void execute(const std::function<void(int)>& job, int participant) {
+        try {
+            job(participant);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_) error_ = std::current_exception();
+        }
+    }
+
+    const int size_;
+    std::vector<std::thread> workers_;
+
+    std::mutex runMutex_;
+    std::mutex mutex_;
+    std::mutex errorMutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(int)>* job_ = nullptr;
+    unsigned generation_ = 0;
+    int pending_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
@@ -8,7 +8,7 @@
  * American Call option under Black–Scholes.
  * Early exercise can be optimal when q > 0.
  */
-class AmericanCall : public InterfaceProducts {
+class AmericanCall final : public InterfaceProducts {
 public:
     AmericanCall(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
@@ -20,12 +20,16 @@ public:
         return std::max(S - K_, 0.0);
     }
 
-    bool isAmerican() const override { return true; }
+    static constexpr bool kAmerican = true;
+    bool isAmerican() const override { return kAmerican; }
 
     double earlyExerciseValue(double S) const override {
         return payoff(S);
     }
 
+    // Exercise region S >= S*(t) (empty when q <= 0)
+    int exerciseSide() const override { return 1; }
+
     // At S = 0: worthless
     double leftBoundary(double /*t*/) const override {
         return 0.0;
@@ -7,7 +7,7 @@
 /**
  * American Put option under Black–Scholes.
  */
-class AmericanPut : public InterfaceProducts {
+class AmericanPut final : public InterfaceProducts {
 public:
     AmericanPut(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
@@ -19,13 +19,17 @@ public:
         return std::max(K_ - S, 0.0);
     }
 
-    bool isAmerican() const override { return true; }
+    static constexpr bool kAmerican = true;
+    bool isAmerican() const override { return kAmerican; }
 
     // Immediate exercise value
     double earlyExerciseValue(double S) const override {
         return payoff(S);
     }
 
+    // Exercise region S <= S*(t)
+    int exerciseSide() const override { return -1; }
+
     // At S = 0: for an American put, immediate exercise is optimal -> value = K
     double leftBoundary(double /*t*/) const override {
         return K_;
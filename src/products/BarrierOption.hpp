@@ -0,0 +1,118 @@
+#pragma once
+#include "InterfaceProducts.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/**
+ * Knock-out barrier option: up-and-out / down-and-out call or put, with an
+ * optional rebate paid when the barrier is hit.
+ *
+ * Continuously monitored by default: the grid builders end the S-domain on
+ * the barrier, whose boundary value is the rebate, so no node beyond it is
+ * ever computed. With monitoring dates the barrier is only checked on those
+ * dates: the domain extends past it and the solver resets the value beyond
+ * it to the rebate at each date (the rebate is then paid on that date).
+ */
+class BarrierOption final : public InterfaceProducts {
+public:
+    static constexpr bool kAmerican = false;
+
+    enum class Type { UpAndOutCall, UpAndOutPut, DownAndOutCall, DownAndOutPut };
+
+    BarrierOption(Type type, double strike, double barrier, double maturity,
+                  const BlackScholesModel& model, double rebate = 0.0,
+                  std::vector<double> monitoringDates = {})
+        : type_(type), K_(strike), H_(barrier), T_(maturity), rebate_(rebate),
+          dates_(std::move(monitoringDates)), model_(model)
+    {
+        if (!(H_ > 0.0)) throw std::invalid_argument("Barrier must be > 0.");
+        if (rebate_ < 0.0) throw std::invalid_argument("Rebate must be >= 0.");
+        for (std::size_t k = 0; k < dates_.size(); ++k) {
+            if (dates_[k] < 0.0 || dates_[k] > T_ || (k > 0 && !(dates_[k] > dates_[k - 1])))
+                throw std::invalid_argument("Monitoring dates must be increasing in [0, T].");
+        }
+    }
+
+    Type type() const { return type_; }
+    double barrier() const { return H_; }
+    double rebate() const { return rebate_; }
+
+    double maturity() const override { return T_; }
+    double strike() const override { return K_; }
+
+    // Continuous monitoring includes expiry: knocked-out nodes pay the rebate
+    double payoff(double S) const override {
+        if (dates_.empty() && knockedOut(S)) return rebate_;
+        return vanilla(S);
+    }
+
+    double lowerBarrier() const override { return up() ? 0.0 : H_; }
+    double upperBarrier() const override {
+        return up() ? H_ : std::numeric_limits<double>::infinity();
+    }
+
+    std::vector<double> monitoringDates() const override { return dates_; }
+
+    // A node on the barrier takes the mean of both sides of the jump, which
+    // keeps the reset second-order accurate in dS
+    double knockOut(double S, double V) const override {
+        if (std::fabs(S - H_) <= 1e-12 * H_) return 0.5 * (rebate_ + V);
+        return knockedOut(S) ? rebate_ : V;
+    }
+
+    // S = Smin: the barrier itself for a continuous down-and-out; otherwise
+    // S stays at 0 (knocked out on the next date below a discrete barrier)
+    double leftBoundary(double t) const override {
+        if (!up()) {
+            if (dates_.empty()) return rebate_;
+            const double next = nextDate(t);
+            if (next <= T_) return rebate_ * std::exp(-model_.r() * (next - t));
+        }
+        const double tau = T_ - t;
+        if (call() || tau <= 0.0) return vanilla(0.0);
+        return K_ * std::exp(-model_.r() * tau);
+    }
+
+    // S = Smax: the barrier itself for a continuous up-and-out; beyond a
+    // discrete up barrier, knocked out on the next date; far-field vanilla
+    // value otherwise
+    double rightBoundary(double t, double Smax) const override {
+        if (up()) {
+            if (dates_.empty()) return rebate_;
+            const double next = nextDate(t);
+            if (Smax >= H_ && next <= T_) return rebate_ * std::exp(-model_.r() * (next - t));
+        }
+        const double tau = T_ - t;
+        if (!call() || tau <= 0.0) return vanilla(Smax);
+        return Smax * std::exp(-model_.q() * tau) - K_ * std::exp(-model_.r() * tau);
+    }
+
+private:
+    Type type_;
+    double K_;
+    double H_;
+    double T_;
+    double rebate_;
+    std::vector<double> dates_;
+    const BlackScholesModel& model_;
+
+    bool up() const { return type_ == Type::UpAndOutCall || type_ == Type::UpAndOutPut; }
+    bool call() const { return type_ == Type::UpAndOutCall || type_ == Type::DownAndOutCall; }
+
+    bool knockedOut(double S) const { return up() ? S >= H_ : S <= H_; }
+
+    double vanilla(double S) const {
+        return call() ? std::max(S - K_, 0.0) : std::max(K_ - S, 0.0);
+    }
+
+    // First monitoring date >= t (past T when none is left)
+    double nextDate(double t) const {
+        const auto it = std::lower_bound(dates_.begin(), dates_.end(), t);
+        return it == dates_.end() ? std::numeric_limits<double>::infinity() : *it;
+    }
+};
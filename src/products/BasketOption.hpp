@@ -0,0 +1,40 @@
+#pragma once
+#include "InterfaceTwoAssetProducts.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Call or put on a two-asset basket w1 S1 + w2 S2, European or American
+ */
+class BasketOption final : public InterfaceTwoAssetProducts {
+public:
+    enum class Type { Call, Put };
+
+    BasketOption(Type type, double strike, double maturity, double w1, double w2, bool american = false)
+        : type_(type), K_(strike), T_(maturity), w1_(w1), w2_(w2), american_(american)
+    {
+        if (w1_ < 0.0 || w2_ < 0.0) throw std::invalid_argument("Basket weights must be >= 0.");
+    }
+
+    Type type() const { return type_; }
+    double weight1() const { return w1_; }
+    double weight2() const { return w2_; }
+
+    double maturity() const override { return T_; }
+    double strike() const override { return K_; }
+
+    double payoff(double S1, double S2) const override {
+        const double basket = w1_ * S1 + w2_ * S2;
+        return type_ == Type::Call ? std::max(basket - K_, 0.0) : std::max(K_ - basket, 0.0);
+    }
+
+    bool isAmerican() const override { return american_; }
+
+private:
+    Type type_;
+    double K_;
+    double T_;
+    double w1_;
+    double w2_;
+    bool american_;
+};
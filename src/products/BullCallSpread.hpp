@@ -4,9 +4,12 @@
 #include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
-class BullCallSpread : public InterfaceProducts {
+class BullCallSpread final : public InterfaceProducts {
 public:
+    static constexpr bool kAmerican = false;
+
     BullCallSpread(double K1, double K2, double maturity, const BlackScholesModel& model)
         : K1_(K1), K2_(K2), T_(maturity), model_(model)
     {
@@ -16,6 +19,11 @@ public:
     double maturity() const override { return T_; }
     double strike() const override { return K1_; } 
 
+    double lowerStrike() const { return K1_; }
+    double upperStrike() const { return K2_; }
+
+    std::vector<double> strikes() const override { return {K1_, K2_}; }
+
     double payoff(double S) const override {
         return std::max(S - K1_, 0.0) - std::max(S - K2_, 0.0);
     }
@@ -4,8 +4,10 @@
 #include <algorithm>
 #include <cmath>
 
-class EuropeanCall : public InterfaceProducts {
+class EuropeanCall final : public InterfaceProducts {
 public:
+    static constexpr bool kAmerican = false;
+
     EuropeanCall(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
 
@@ -4,8 +4,10 @@
 #include <algorithm>
 #include <cmath>
 
-class EuropeanPut : public InterfaceProducts {
+class EuropeanPut final : public InterfaceProducts {
 public:
+    static constexpr bool kAmerican = false;
+
     EuropeanPut(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
 
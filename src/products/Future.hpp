@@ -7,8 +7,10 @@
  * Future/Forward-like contract: payoff = (S - K) at maturity.
  * Under dividends q, the fair forward price uses exp(-qT) on S and exp(-rT) on K.
  */
-class Future : public InterfaceProducts {
+class Future final : public InterfaceProducts {
 public:
+    static constexpr bool kAmerican = false;
+
     Future(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
 
@@ -1,7 +1,18 @@
 #pragma once
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+class BlackScholesModel;
 
 /**
  * Interface for option products
+ *
+ * Concrete products are declared final and expose
+ * `static constexpr bool kAmerican`, so that solvers can instantiate a
+ * devirtualized kernel per product type (ExplicitFdSolver::priceProduct).
  */
 class InterfaceProducts {
 public:
@@ -11,6 +22,9 @@ public:
     virtual double maturity() const = 0;
     virtual double strike() const = 0;
 
+    // Kinks of the payoff; non-uniform grids are concentrated around them
+    virtual std::vector<double> strikes() const { return {strike()}; }
+
     // Terminal payoff V(T, S)
     virtual double payoff(double S) const = 0;
 
@@ -21,4 +35,29 @@ public:
     // Early exercise (for American options)
     virtual bool isAmerican() const { return false; }
     virtual double earlyExerciseValue(double S) const { return payoff(S); }
+
+    // Side of the early-exercise boundary S*(t) where exercise is optimal:
+    // -1 below it (puts), +1 above it (calls), 0 unknown (obstacle applied
+    // everywhere)
+    virtual int exerciseSide() const { return 0; }
+
+    // Knock-out barriers (0 / +inf: none). Continuously monitored barriers
+    // are domain boundaries: the GridParameters builders end the S-domain
+    // on them and leftBoundary / rightBoundary give the value there.
+    virtual double lowerBarrier() const { return 0.0; }
+    virtual double upperBarrier() const { return std::numeric_limits<double>::infinity(); }
+
+    // Discrete monitoring dates in [0, T], increasing (empty: continuous
+    // monitoring). At each date the solver replaces the continuation value
+    // V at S by knockOut(S, V).
+    virtual std::vector<double> monitoringDates() const { return {}; }
+    virtual double knockOut(double /*S*/, double V) const { return V; }
+
+    bool continuousBarrier() const {
+        return (lowerBarrier() > 0.0 || std::isfinite(upperBarrier())) && monitoringDates().empty();
+    }
 };
+
+// Builds a product against a given model (products keep a reference to it),
+// for solvers that price one contract under models they own
+using ProductBuilder = std::function<std::unique_ptr<InterfaceProducts>(const BlackScholesModel&)>;
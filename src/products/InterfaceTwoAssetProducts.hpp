@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * Interface for products on two underlyings (AdiFdSolver)
+ *
+ * No boundary values: the two-asset solver needs none (the PDE degenerates
+ * on the S = 0 edges and values are linear at the far edges).
+ */
+class InterfaceTwoAssetProducts {
+public:
+    virtual ~InterfaceTwoAssetProducts() = default;
+
+    // Contract parameters
+    virtual double maturity() const = 0;
+    virtual double strike() const = 0;
+
+    // Terminal payoff V(T, S1, S2)
+    virtual double payoff(double S1, double S2) const = 0;
+
+    // Early exercise (for American options)
+    virtual bool isAmerican() const { return false; }
+    virtual double earlyExerciseValue(double S1, double S2) const { return payoff(S1, S2); }
+};
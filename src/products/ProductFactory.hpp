@@ -0,0 +1,113 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "InterfaceProducts.hpp"
+#include "AmericanCall.hpp"
+#include "AmericanPut.hpp"
+#include "BarrierOption.hpp"
+#include "BearPutSpread.hpp"
+#include "BullCallSpread.hpp"
+#include "EuropeanCall.hpp"
+#include "EuropeanPut.hpp"
+#include "Future.hpp"
+#include "Straddle.hpp"
+
+/**
+ * Builds the library products from a type tag and their strikes, for
+ * file-driven pricing. K2 is only read by the two spreads (upper strike)
+ * and the knock-out options (continuously monitored barrier, no rebate).
+ * Products keep a reference to the model: it must outlive them.
+ */
+enum class ProductType : std::uint32_t {
+    EuropeanCall,
+    EuropeanPut,
+    AmericanCall,
+    AmericanPut,
+    Future,
+    BullCallSpread,
+    BearPutSpread,
+    Straddle,
+    UpAndOutCall,
+    UpAndOutPut,
+    DownAndOutCall,
+    DownAndOutPut
+};
+
+namespace ProductFactory {
+
+inline const char* name(ProductType type) {
+    switch (type) {
+        case ProductType::EuropeanCall:   return "european_call";
+        case ProductType::EuropeanPut:    return "european_put";
+        case ProductType::AmericanCall:   return "american_call";
+        case ProductType::AmericanPut:    return "american_put";
+        case ProductType::Future:         return "future";
+        case ProductType::BullCallSpread: return "bull_call_spread";
+        case ProductType::BearPutSpread:  return "bear_put_spread";
+        case ProductType::Straddle:       return "straddle";
+        case ProductType::UpAndOutCall:   return "up_and_out_call";
+        case ProductType::UpAndOutPut:    return "up_and_out_put";
+        case ProductType::DownAndOutCall: return "down_and_out_call";
+        case ProductType::DownAndOutPut:  return "down_and_out_put";
+    }
+    return "unknown";
+}
+
+// Inverse of name(); throws std::invalid_argument on an unknown tag
+inline ProductType parse(const std::string& tag) {
+    for (int t = 0; t <= static_cast<int>(ProductType::DownAndOutPut); ++t) {
+        const ProductType type = static_cast<ProductType>(t);
+        if (tag == name(type)) return type;
+    }
+    throw std::invalid_argument("Unknown product type '" + tag + "'.");
+}
+
+inline bool twoStrikes(ProductType type) {
+    return type == ProductType::BullCallSpread || type == ProductType::BearPutSpread;
+}
+
+inline bool knockOut(ProductType type) {
+    return type == ProductType::UpAndOutCall || type == ProductType::UpAndOutPut
+        || type == ProductType::DownAndOutCall || type == ProductType::DownAndOutPut;
+}
+
+// Whether K2 is part of the trade
+inline bool readsK2(ProductType type) {
+    return twoStrikes(type) || knockOut(type);
+}
+
+inline std::unique_ptr<InterfaceProducts> make(ProductType type, double K1, double K2, double T,
+                                               const BlackScholesModel& model)
+{
+    if (!(T > 0.0)) throw std::invalid_argument("Maturity T must be > 0.");
+
+    switch (type) {
+        case ProductType::EuropeanCall:   return std::make_unique<EuropeanCall>(K1, T, model);
+        case ProductType::EuropeanPut:    return std::make_unique<EuropeanPut>(K1, T, model);
+        case ProductType::AmericanCall:   return std::make_unique<AmericanCall>(K1, T, model);
+        case ProductType::AmericanPut:    return std::make_unique<AmericanPut>(K1, T, model);
+        case ProductType::Future:         return std::make_unique<Future>(K1, T, model);
+        case ProductType::BullCallSpread: return std::make_unique<BullCallSpread>(K1, K2, T, model);
+        case ProductType::BearPutSpread:  return std::make_unique<BearPutSpread>(K1, K2, T, model);
+        case ProductType::Straddle:       return std::make_unique<Straddle>(K1, T, model);
+        case ProductType::UpAndOutCall:
+            return std::make_unique<BarrierOption>(BarrierOption::Type::UpAndOutCall, K1, K2, T, model);
+        case ProductType::UpAndOutPut:
+            return std::make_unique<BarrierOption>(BarrierOption::Type::UpAndOutPut, K1, K2, T, model);
+        case ProductType::DownAndOutCall:
+            return std::make_unique<BarrierOption>(BarrierOption::Type::DownAndOutCall, K1, K2, T, model);
+        case ProductType::DownAndOutPut:
+            return std::make_unique<BarrierOption>(BarrierOption::Type::DownAndOutPut, K1, K2, T, model);
+    }
+    throw std::invalid_argument("Unknown product type.");
+}
+
+// Same as a ProductBuilder, for solvers that own the model
+inline ProductBuilder builder(ProductType type, double K1, double K2, double T)
+{
+    return [=](const BlackScholesModel& model) { return make(type, K1, K2, T, model); };
+}
+
+} // namespace ProductFactory
@@ -0,0 +1,35 @@
+#pragma once
+#include "InterfaceTwoAssetProducts.hpp"
+#include <algorithm>
+
+/**
+ * Call or put on the spread S1 - S2, European or American
+ * (K = 0: the option to exchange asset 2 for asset 1)
+ */
+class SpreadOption final : public InterfaceTwoAssetProducts {
+public:
+    enum class Type { Call, Put };
+
+    SpreadOption(Type type, double strike, double maturity, bool american = false)
+        : type_(type), K_(strike), T_(maturity), american_(american)
+    {
+    }
+
+    Type type() const { return type_; }
+
+    double maturity() const override { return T_; }
+    double strike() const override { return K_; }
+
+    double payoff(double S1, double S2) const override {
+        const double spread = S1 - S2;
+        return type_ == Type::Call ? std::max(spread - K_, 0.0) : std::max(K_ - spread, 0.0);
+    }
+
+    bool isAmerican() const override { return american_; }
+
+private:
+    Type type_;
+    double K_;
+    double T_;
+    bool american_;
+};
@@ -4,8 +4,10 @@
 #include <algorithm>
 #include <cmath>
 
-class Straddle : public InterfaceProducts {
+class Straddle final : public InterfaceProducts {
 public:
+    static constexpr bool kAmerican = false;
+
     Straddle(double strike, double maturity, const BlackScholesModel& model)
         : K_(strike), T_(maturity), model_(model) {}
 
@@ -0,0 +1,93 @@
+#include "AdaptivePricer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "../grid/GridParameters.hpp"
+
+namespace {
+
+// Richardson extrapolation of an order-p quantity over a halved step
+inline double richardson(double fine, double coarse, double p)
+{
+    return fine + (fine - coarse) / (std::pow(2.0, p) - 1.0);
+}
+
+} // namespace
+
+AdaptivePricer::AdaptivePricer(const Config& config)
+    : config_(config)
+{
+    if (config_.absTol < 0.0 || config_.relTol < 0.0 || config_.absTol + config_.relTol <= 0.0)
+        throw std::invalid_argument("AdaptivePricer needs absTol > 0 or relTol > 0.");
+    if (config_.initialRelDs <= 0.0 || config_.minRelDs <= 0.0 || config_.minRelDs > config_.initialRelDs)
+        throw std::invalid_argument("AdaptivePricer needs 0 < minRelDs <= initialRelDs.");
+}
+
+AdaptivePricer::Priced AdaptivePricer::price(const InterfaceProducts& product,
+                                            const BlackScholesModel& model,
+                                            double S0) const
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    Priced out;
+    ExplicitFdSolver::Result coarse;
+    ExplicitFdSolver::Result prevExtrapolated;
+
+    // Nt floor doubled with each level, so that both steps halve together
+    int minTimeSteps = 25;
+
+    for (double rel_dS = config_.initialRelDs; ; rel_dS *= 0.5, minTimeSteps *= 2) {
+        FdGrid grid = GridParameters::makeClusteredImplicitGrid(product, model, S0, rel_dS, 0.0, minTimeSteps);
+        ExplicitFdSolver::Result fine = solver_.price(product, model, grid, S0);
+
+        out.levels.push_back({rel_dS, grid.Nt(), grid.Ns(), fine.price});
+        out.rel_dS = rel_dS;
+        out.Nt = grid.Nt();
+        out.Ns = grid.Ns();
+
+        const int level = static_cast<int>(out.levels.size());
+        if (level == 1) {
+            out.result = fine;
+            out.errorEstimate = std::numeric_limits<double>::infinity();
+        } else {
+            // Observed order from the last three levels, kept within the
+            // orders the scheme can show: 2 (smooth, Crank-Nicolson), 1
+            // (early-exercise boundary)
+            double p = 2.0;
+            if (level >= 3) {
+                const double d1 = std::fabs(out.levels[level - 2].price - out.levels[level - 3].price);
+                const double d2 = std::fabs(fine.price - coarse.price);
+                if (d1 > 0.0 && d2 > 0.0) p = std::min(std::max(std::log2(d1 / d2), 1.0), 2.0);
+            }
+            out.order = p;
+
+            ExplicitFdSolver::Result extrapolated;
+            extrapolated.price = richardson(fine.price, coarse.price, p);
+            extrapolated.delta = richardson(fine.delta, coarse.delta, p);
+            extrapolated.gamma = richardson(fine.gamma, coarse.gamma, p);
+
+            out.errorEstimate = (level == 2)
+                ? std::fabs(fine.price - coarse.price) / (std::pow(2.0, p) - 1.0)
+                : std::fabs(extrapolated.price - prevExtrapolated.price);
+
+            prevExtrapolated = extrapolated;
+            extrapolated.V0 = fine.V0;
+            out.result = std::move(extrapolated);
+        }
+
+        const double tol = std::max(config_.absTol, config_.relTol * std::fabs(out.result.price));
+        if (out.errorEstimate <= tol) {
+            out.converged = true;
+            break;
+        }
+        if (0.5 * rel_dS < config_.minRelDs) break;
+
+        coarse = std::move(fine);
+    }
+
+    out.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return out;
+}
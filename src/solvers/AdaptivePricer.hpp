@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "ThetaFdSolver.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+/**
+ * Accuracy-targeted PDE pricing
+ *
+ * Solves with Crank–Nicolson on strike-clustered grids
+ * (GridParameters::makeClusteredImplicitGrid), halving rel_dS (so doubling
+ * Ns and Nt) from a coarse start. Each pair of levels gives a Richardson
+ * extrapolation P + (P - P_coarse) / (2^p - 1), with p = 2 at first and
+ * then the order observed over the last three levels (clamped to [1, 2]:
+ * American prices converge at first order). The error estimate is
+ * |P - P_coarse| / 3 after two levels, then the change between successive
+ * extrapolations. Refinement stops at the first level
+ * whose estimate meets max(absTol, relTol * |price|), or at minRelDs.
+ */
+class AdaptivePricer {
+public:
+    struct Config {
+        double absTol = 1e-4;        // target absolute price error
+        double relTol = 0.0;         // target error relative to the price
+        double initialRelDs = 0.02;  // coarsest level
+        double minRelDs = 1e-4;      // finest level allowed
+    };
+
+    struct Level {
+        double rel_dS;
+        int Nt;
+        int Ns;
+        double price;                // raw (non-extrapolated) price
+    };
+
+    struct Priced {
+        ExplicitFdSolver::Result result; // extrapolated price/Greeks, V0 of the last level
+        double errorEstimate = 0.0;
+        double order = 2.0;              // convergence order used to extrapolate
+        bool converged = false;          // tolerance met before minRelDs
+        double rel_dS = 0.0;             // last level
+        int Nt = 0;
+        int Ns = 0;
+        double seconds = 0.0;            // wall time of all levels
+        std::vector<Level> levels;
+    };
+
+    AdaptivePricer() = default;
+    explicit AdaptivePricer(const Config& config);
+
+    const Config& config() const { return config_; }
+
+    Priced price(const InterfaceProducts& product,
+                 const BlackScholesModel& model,
+                 double S0) const;
+
+private:
+    Config config_;
+    ThetaFdSolver solver_;
+};
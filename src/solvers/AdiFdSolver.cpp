@@ -0,0 +1,391 @@
+#include "AdiFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Buffer = SolverWorkspace::Buffer;
+
+constexpr int kRowBlock = 8;       // asset-1 lines per task
+constexpr int kColumnBlock = 64;   // asset-2 lines per task, swept together
+
+// Operator along one axis per unit of time, L V = a V[k-1] + b V[k] + c V[k+1]
+// at node k, with half of the discounting. Zero at the far node, which
+// follows from the linearity condition instead.
+struct AxisOperator {
+    std::vector<double> a, b, c;
+};
+
+AxisOperator axisOperator(const FdGrid& axis, double sigma, double mu, double r)
+{
+    const int N = axis.Ns();
+    const auto& S = axis.priceGrid();
+    AxisOperator L{std::vector<double>(N + 1, 0.0), std::vector<double>(N + 1, 0.0),
+                   std::vector<double>(N + 1, 0.0)};
+
+    // S = 0: only the discounting is left
+    L.b[0] = -0.5 * r;
+    for (int k = 1; k < N; ++k) {
+        const FdGrid::Weights d = axis.weights(k);
+        const double halfSig2S2 = 0.5 * sigma * sigma * S[k] * S[k];
+        const double muS = mu * S[k];
+
+        L.a[k] = halfSig2S2 * d.d2m + muS * d.d1m;
+        L.b[k] = halfSig2S2 * d.d2c + muS * d.d1c - 0.5 * r;
+        L.c[k] = halfSig2S2 * d.d2p + muS * d.d1p;
+    }
+    return L;
+}
+
+// First-derivative weights times S at the interior nodes of one axis
+// (zero at both ends: the cross term vanishes at S = 0 and is dropped on
+// the far edge), scaled by `scale`
+struct AxisSlopes {
+    std::vector<double> m, c, p;
+};
+
+AxisSlopes axisSlopes(const FdGrid& axis, double scale)
+{
+    const int N = axis.Ns();
+    const auto& S = axis.priceGrid();
+    AxisSlopes D{std::vector<double>(N + 1, 0.0), std::vector<double>(N + 1, 0.0),
+                 std::vector<double>(N + 1, 0.0)};
+
+    for (int k = 1; k < N; ++k) {
+        const FdGrid::Weights d = axis.weights(k);
+        D.m[k] = scale * S[k] * d.d1m;
+        D.c[k] = scale * S[k] * d.d1c;
+        D.p[k] = scale * S[k] * d.d1p;
+    }
+    return D;
+}
+
+// LU factors of (I - theta dt L) on nodes 0..N-1 of one axis; the far node
+// is eliminated through the linearity condition V[N] = 2 V[N-1] - V[N-2]
+struct AxisFactors {
+    std::vector<double> sub, invDen, sup;
+};
+
+AxisFactors factorize(const AxisOperator& L, double theta, double dt)
+{
+    const int N = static_cast<int>(L.b.size()) - 1;
+    AxisFactors f{std::vector<double>(N + 1, 0.0), std::vector<double>(N + 1, 0.0),
+                  std::vector<double>(N + 1, 0.0)};
+
+    double prevSup = 0.0;
+    for (int k = 0; k < N; ++k) {
+        double l = -theta * dt * L.a[k];
+        double d = 1.0 - theta * dt * L.b[k];
+        double u = -theta * dt * L.c[k];
+        if (k == N - 1) {
+            l -= u;
+            d += 2.0 * u;
+            u = 0.0;
+        }
+
+        const double den = d - l * prevSup;
+        if (den == 0.0) throw std::runtime_error("Singular tridiagonal system in AdiFdSolver.");
+
+        f.sub[k] = l;
+        f.invDen[k] = 1.0 / den;
+        f.sup[k] = u / den;
+        prevSup = f.sup[k];
+    }
+    return f;
+}
+
+// Thomas sweep in place on one contiguous line of N+1 values
+void solveLine(const AxisFactors& f, double* x, int N)
+{
+    x[0] *= f.invDen[0];
+    for (int k = 1; k < N; ++k) {
+        x[k] = (x[k] - f.sub[k] * x[k - 1]) * f.invDen[k];
+    }
+    for (int k = N - 2; k >= 0; --k) {
+        x[k] -= f.sup[k] * x[k + 1];
+    }
+    x[N] = 2.0 * x[N - 1] - x[N - 2];
+}
+
+// Same on the columns [i0, i1) of a row-major array with row stride n1,
+// lines along the rows: all columns of the block advance together, so the
+// inner loops run over contiguous memory
+void solveColumns(const AxisFactors& f, double* Y, int n1, int N, int i0, int i1)
+{
+    for (int i = i0; i < i1; ++i) Y[i] *= f.invDen[0];
+    for (int k = 1; k < N; ++k) {
+        double* row = Y + static_cast<std::size_t>(k) * n1;
+        const double* prev = row - n1;
+        const double sub = f.sub[k];
+        const double inv = f.invDen[k];
+        for (int i = i0; i < i1; ++i) row[i] = (row[i] - sub * prev[i]) * inv;
+    }
+    for (int k = N - 2; k >= 0; --k) {
+        double* row = Y + static_cast<std::size_t>(k) * n1;
+        const double* next = row + n1;
+        const double sup = f.sup[k];
+        for (int i = i0; i < i1; ++i) row[i] -= sup * next[i];
+    }
+    double* last = Y + static_cast<std::size_t>(N) * n1;
+    for (int i = i0; i < i1; ++i) last[i] = 2.0 * last[i - n1] - last[i - 2 * n1];
+}
+
+// Discretized operator: A1 (rows), A2 (columns), A0 (cross term)
+struct Operators {
+    AxisOperator L1, L2;
+    AxisSlopes D1, D2;   // D2 carries rho s1 s2
+    int N1, N2;
+
+    // A1 V on row j
+    void applyA1(const double* v, double* out) const {
+        out[0] = L1.b[0] * v[0];
+        for (int i = 1; i < N1; ++i)
+            out[i] = L1.a[i] * v[i - 1] + L1.b[i] * v[i] + L1.c[i] * v[i + 1];
+        out[N1] = 0.0;
+    }
+
+    // A2 V on row j (vm, vp: rows j-1, j+1, unused where their weight is 0)
+    void applyA2(int j, const double* vm, const double* v, const double* vp, double* out) const {
+        const double a = L2.a[j], b = L2.b[j], c = L2.c[j];
+        if (j == 0) {
+            for (int i = 0; i <= N1; ++i) out[i] = b * v[i];
+        } else if (j == N2) {
+            for (int i = 0; i <= N1; ++i) out[i] = 0.0;
+        } else {
+            for (int i = 0; i <= N1; ++i) out[i] = a * vm[i] + b * v[i] + c * vp[i];
+        }
+    }
+
+    // A0 V on row j: rho s1 s2 S1 S2 d2V/dS1dS2 from the product of the
+    // first-derivative weights (zero on the edges)
+    void applyA0(int j, const double* vm, const double* v, const double* vp, double* out) const {
+        out[0] = out[N1] = 0.0;
+        if (j == 0 || j == N2) {
+            for (int i = 1; i < N1; ++i) out[i] = 0.0;
+            return;
+        }
+        const double ym = D2.m[j], yc = D2.c[j], yp = D2.p[j];
+        for (int i = 1; i < N1; ++i) {
+            const double dm = D1.m[i] * vm[i - 1] + D1.c[i] * vm[i] + D1.p[i] * vm[i + 1];
+            const double dc = D1.m[i] * v[i - 1]  + D1.c[i] * v[i]  + D1.p[i] * v[i + 1];
+            const double dp = D1.m[i] * vp[i - 1] + D1.c[i] * vp[i] + D1.p[i] * vp[i + 1];
+            out[i] = ym * dm + yc * dc + yp * dp;
+        }
+    }
+};
+
+// i such that S[i] <= x < S[i+1], within [0, N-1]
+int bracket(const std::vector<double>& S, double x)
+{
+    const int N = static_cast<int>(S.size()) - 1;
+    const int i = static_cast<int>(std::upper_bound(S.begin(), S.end(), x) - S.begin()) - 1;
+    return std::min(std::max(i, 0), N - 1);
+}
+
+// Runs body(begin, end) over [0, n) in blocks, across the pool if any
+template <class Body>
+void forBlocks(ThreadPool* pool, int n, int block, const Body& body)
+{
+    const int tasks = (n + block - 1) / block;
+    auto task = [&](int t, int /*participant*/) { body(t * block, std::min(n, (t + 1) * block)); };
+
+    if (pool && pool->size() > 1 && tasks > 1) {
+        pool->parallelFor(tasks, task);
+    } else {
+        for (int t = 0; t < tasks; ++t) task(t, 0);
+    }
+}
+
+} // namespace
+
+AdiFdSolver::AdiFdSolver(Scheme scheme, double theta, int dampingSteps)
+    : scheme_(scheme), theta_(theta), dampingSteps_(dampingSteps)
+{
+    if (theta_ < 0.5 || theta_ > 1.0)
+        throw std::invalid_argument("theta must be in [0.5, 1] for unconditional stability.");
+    if (dampingSteps_ < 0)
+        throw std::invalid_argument("dampingSteps must be >= 0.");
+}
+
+void AdiFdSolver::validateGrid(const FdGrid2D& grid)
+{
+    if (grid.axis1().priceGrid().front() != 0.0 || grid.axis2().priceGrid().front() != 0.0)
+        throw std::invalid_argument("Both axes of a 2D grid must start at S = 0.");
+}
+
+AdiFdSolver::Result AdiFdSolver::price(const InterfaceTwoAssetProducts& option,
+                                       const TwoAssetModel& model,
+                                       const FdGrid2D& grid,
+                                       double S1,
+                                       double S2) const
+{
+    validateGrid(grid);
+    if (std::fabs(option.maturity() - grid.T()) > 1e-12 * grid.T())
+        throw std::invalid_argument("Product maturity differs from the grid maturity.");
+
+    const int N1 = grid.N1();
+    const int N2 = grid.N2();
+    const int n1 = N1 + 1;
+    const int n2 = N2 + 1;
+    const int Nt = grid.Nt();
+    const double dt = grid.dt();
+    const auto& X = grid.axis1().priceGrid();
+    const auto& Y = grid.axis2().priceGrid();
+    const double r = model.r();
+
+    const Operators ops{axisOperator(grid.axis1(), model.sigma1(), r - model.q1(), r),
+                        axisOperator(grid.axis2(), model.sigma2(), r - model.q2(), r),
+                        axisSlopes(grid.axis1(), 1.0),
+                        axisSlopes(grid.axis2(), model.rho() * model.sigma1() * model.sigma2()),
+                        N1, N2};
+
+    const int startSteps = std::min(dampingSteps_, Nt);
+    const AxisFactors F1 = factorize(ops.L1, theta_, dt);
+    const AxisFactors F2 = factorize(ops.L2, theta_, dt);
+    const AxisFactors H1 = startSteps > 0 ? factorize(ops.L1, 1.0, 0.5 * dt) : AxisFactors{};
+    const AxisFactors H2 = startSteps > 0 ? factorize(ops.L2, 1.0, 0.5 * dt) : AxisFactors{};
+
+    // Terminal condition and obstacle
+    const std::size_t size = grid.size();
+    Buffer Ubuf(size), Ybuf(size), Zbuf(size), A0U(size), A1U(size), A2U(size);
+    Buffer obstacle(option.isAmerican() ? size : 0);
+    for (int j = 0; j < n2; ++j) {
+        for (int i = 0; i < n1; ++i) {
+            Ubuf[grid.index(i, j)] = option.payoff(X[i], Y[j]);
+            if (!obstacle.empty()) obstacle[grid.index(i, j)] = option.earlyExerciseValue(X[i], Y[j]);
+        }
+    }
+
+    double* U = Ubuf.data();
+    double* Yv = Ybuf.data();
+    double* Zv = Zbuf.data();
+    auto row = [n1](double* base, int j) { return base + static_cast<std::size_t>(j) * n1; };
+    auto rowAbove = [&](double* base, int j) { return row(base, std::max(j - 1, 0)); };
+    auto rowBelow = [&](double* base, int j) { return row(base, std::min(j + 1, N2)); };
+
+    // Asset-2 solve and projection on the columns [i0, i1) of W
+    auto columnStage = [&](double* W, double th, double h, const AxisFactors& F, int i0, int i1) {
+        for (int j = 0; j < n2; ++j) {
+            double* w = row(W, j);
+            const double* a2 = row(A2U.data(), j);
+            for (int i = i0; i < i1; ++i) w[i] -= th * h * a2[i];
+        }
+        solveColumns(F, W, n1, N2, i0, i1);
+        if (!obstacle.empty()) {
+            for (int j = 0; j < n2; ++j) {
+                double* w = row(W, j);
+                const double* o = row(obstacle.data(), j);
+                for (int i = i0; i < i1; ++i) w[i] = std::max(w[i], o[i]);
+            }
+        }
+    };
+
+    // One step of size h from U: Douglas predictor into Y, then (Craig–Sneyd)
+    // the corrector into Z; returns the buffer holding the new values
+    auto step = [&](Scheme scheme, double th, double h, const AxisFactors& G1, const AxisFactors& G2) {
+        const bool corrector = scheme == Scheme::CraigSneyd;
+
+        // Y0 = U + h A U, minus the implicit part of A1, then the asset-1 solves
+        forBlocks(pool_, n2, kRowBlock, [&](int j0, int j1) {
+            for (int j = j0; j < j1; ++j) {
+                const double* u = row(U, j);
+                double* a0 = row(A0U.data(), j);
+                double* a1 = row(A1U.data(), j);
+                double* a2 = row(A2U.data(), j);
+                ops.applyA0(j, rowAbove(U, j), u, rowBelow(U, j), a0);
+                ops.applyA1(u, a1);
+                ops.applyA2(j, rowAbove(U, j), u, rowBelow(U, j), a2);
+
+                double* y = row(Yv, j);
+                for (int i = 0; i < n1; ++i) y[i] = u[i] + h * (a0[i] + (1.0 - th) * a1[i] + a2[i]);
+                solveLine(G1, y, N1);
+            }
+        });
+        forBlocks(pool_, n1, kColumnBlock, [&](int i0, int i1) {
+            columnStage(Yv, th, h, G2, i0, i1);
+        });
+        if (!corrector) return Yv;
+
+        // Z0 = Y0 + h/2 (A0 Y - A0 U), then the same two solves
+        forBlocks(pool_, n2, kRowBlock, [&](int j0, int j1) {
+            for (int j = j0; j < j1; ++j) {
+                const double* u = row(U, j);
+                const double* a0 = row(A0U.data(), j);
+                const double* a1 = row(A1U.data(), j);
+                const double* a2 = row(A2U.data(), j);
+
+                double* z = row(Zv, j);
+                ops.applyA0(j, rowAbove(Yv, j), row(Yv, j), rowBelow(Yv, j), z);
+                for (int i = 0; i < n1; ++i)
+                    z[i] = u[i] + h * (0.5 * a0[i] + (1.0 - th) * a1[i] + a2[i]) + 0.5 * h * z[i];
+                solveLine(G1, z, N1);
+            }
+        });
+        forBlocks(pool_, n1, kColumnBlock, [&](int i0, int i1) {
+            columnStage(Zv, th, h, G2, i0, i1);
+        });
+        return Zv;
+    };
+
+    // The buffer holding the new values becomes U
+    auto advance = [&](double* next) {
+        if (next == Yv) std::swap(U, Yv);
+        else            std::swap(U, Zv);
+    };
+
+    // Backward time stepping
+    for (int n = Nt - 1; n >= 0; --n) {
+        if (Nt - 1 - n < startSteps) {
+            // Damping start-up: two Douglas half-steps with theta = 1
+            advance(step(Scheme::Douglas, 1.0, 0.5 * dt, H1, H2));
+            advance(step(Scheme::Douglas, 1.0, 0.5 * dt, H1, H2));
+        } else {
+            advance(step(scheme_, theta_, dt, F1, F2));
+        }
+    }
+
+    // Price by bilinear interpolation, Greeks at the four bracketing nodes
+    // (kept inside the far edges) interpolated the same way
+    Result res;
+    res.V0.assign(U, U + size);
+
+    const double x = std::min(std::max(S1, X.front()), X.back());
+    const double y = std::min(std::max(S2, Y.front()), Y.back());
+    const int i = bracket(X, x);
+    const int j = bracket(Y, y);
+    const double wx = (x - X[i]) / (X[i + 1] - X[i]);
+    const double wy = (y - Y[j]) / (Y[j + 1] - Y[j]);
+
+    auto V = [&](int a, int b) { return U[grid.index(a, b)]; };
+    res.price = (1.0 - wy) * ((1.0 - wx) * V(i, j) + wx * V(i + 1, j))
+              + wy * ((1.0 - wx) * V(i, j + 1) + wx * V(i + 1, j + 1));
+
+    res.delta1 = res.delta2 = res.gamma11 = res.gamma22 = res.gamma12 = 0.0;
+    for (int b = 0; b < 2; ++b) {
+        for (int a = 0; a < 2; ++a) {
+            const double w = (a ? wx : 1.0 - wx) * (b ? wy : 1.0 - wy);
+            const int k = std::min(std::max(i + a, 1), N1 - 1);
+            const int l = std::min(std::max(j + b, 1), N2 - 1);
+            const FdGrid::Weights dx = grid.axis1().weights(k);
+            const FdGrid::Weights dy = grid.axis2().weights(l);
+            const double mx[3] = {dx.d1m, dx.d1c, dx.d1p};
+            const double my[3] = {dy.d1m, dy.d1c, dy.d1p};
+
+            double cross = 0.0;
+            for (int s = -1; s <= 1; ++s)
+                for (int t = -1; t <= 1; ++t) cross += mx[s + 1] * my[t + 1] * V(k + s, l + t);
+
+            res.delta1  += w * (dx.d1m * V(k - 1, l) + dx.d1c * V(k, l) + dx.d1p * V(k + 1, l));
+            res.delta2  += w * (dy.d1m * V(k, l - 1) + dy.d1c * V(k, l) + dy.d1p * V(k, l + 1));
+            res.gamma11 += w * (dx.d2m * V(k - 1, l) + dx.d2c * V(k, l) + dx.d2p * V(k + 1, l));
+            res.gamma22 += w * (dy.d2m * V(k, l - 1) + dy.d2c * V(k, l) + dy.d2p * V(k, l + 1));
+            res.gamma12 += w * cross;
+        }
+    }
+    return res;
+}
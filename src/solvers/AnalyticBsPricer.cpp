@@ -0,0 +1,214 @@
+#include "AnalyticBsPricer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "../products/EuropeanCall.hpp"
+#include "../products/EuropeanPut.hpp"
+#include "../products/Future.hpp"
+#include "../products/BullCallSpread.hpp"
+#include "../products/BearPutSpread.hpp"
+#include "../products/Straddle.hpp"
+
+namespace normal {
+namespace {
+
+// Chebyshev coefficients of erfc(z), z >= 0 (Numerical Recipes, 3rd ed.)
+constexpr int kNcof = 28;
+constexpr double kCof[kNcof] = {
+    -1.3026537197817094, 6.4196979235649026e-1, 1.9476473204185836e-2,
+    -9.561514786808631e-3, -9.46595344482036e-4, 3.66839497852761e-4,
+    4.2523324806907e-5, -2.0278578112534e-5, -1.624290004647e-6,
+    1.303655835580e-6, 1.5626441722e-8, -8.5238095915e-8,
+    6.529054439e-9, 5.059343495e-9, -9.91364156e-10,
+    -2.27365122e-10, 9.6467911e-11, 2.394038e-12,
+    -6.886027e-12, 8.94487e-13, 3.13092e-13,
+    -1.12708e-13, 3.81e-16, 7.106e-15,
+    -1.523e-15, -9.4e-17, 1.21e-16, -2.8e-17
+};
+
+constexpr double kInvSqrt2   = 0.70710678118654752440;
+constexpr double kInvSqrt2Pi = 0.39894228040143267794;
+
+} // namespace
+
+double pdf(double x) {
+    return kInvSqrt2Pi * std::exp(-0.5 * x * x);
+}
+
+double cdf(double x) {
+    double out;
+    cdf(&x, &out, 1);
+    return out;
+}
+
+void cdf(const double* x, double* out, int n) {
+    // N(x) = erfc(-x/sqrt2)/2, erfc(z) = t*exp(-z^2 + P(ty)) for z = |x|/sqrt2
+    constexpr int kChunk = 64;
+    double z[kChunk], t[kChunk], ty[kChunk], d[kChunk], dd[kChunk];
+
+    for (int base = 0; base < n; base += kChunk) {
+        const int m = std::min(kChunk, n - base);
+
+        for (int k = 0; k < m; ++k) {
+            z[k]  = std::fabs(x[base + k]) * kInvSqrt2;
+            t[k]  = 2.0 / (2.0 + z[k]);
+            ty[k] = 4.0 * t[k] - 2.0;
+            d[k]  = 0.0;
+            dd[k] = 0.0;
+        }
+
+        // Clenshaw recurrence, one coefficient at a time across the chunk
+        for (int j = kNcof - 1; j > 0; --j) {
+            const double c = kCof[j];
+            for (int k = 0; k < m; ++k) {
+                const double tmp = d[k];
+                d[k]  = ty[k] * d[k] - dd[k] + c;
+                dd[k] = tmp;
+            }
+        }
+
+        for (int k = 0; k < m; ++k) {
+            const double erfcz = t[k] * std::exp(-z[k] * z[k] + 0.5 * (kCof[0] + ty[k] * d[k]) - dd[k]);
+            // x < 0: N = erfc(z)/2 ; x >= 0: N = 1 - erfc(z)/2
+            out[base + k] = (x[base + k] < 0.0) ? 0.5 * erfcz : 1.0 - 0.5 * erfcz;
+        }
+    }
+}
+
+} // namespace normal
+
+namespace {
+
+enum class LegKind { Call, Put, Forward };
+
+// weight * (call | put | forward) with strike K, belonging to product `owner`
+struct Leg {
+    int owner;
+    LegKind kind;
+    double K;
+    double weight;
+};
+
+bool decompose(const InterfaceProducts& product, int owner, std::vector<Leg>& legs)
+{
+    if (auto* p = dynamic_cast<const EuropeanCall*>(&product)) {
+        legs.push_back({owner, LegKind::Call, p->strike(), 1.0});
+    } else if (auto* p = dynamic_cast<const EuropeanPut*>(&product)) {
+        legs.push_back({owner, LegKind::Put, p->strike(), 1.0});
+    } else if (auto* p = dynamic_cast<const Future*>(&product)) {
+        legs.push_back({owner, LegKind::Forward, p->strike(), 1.0});
+    } else if (auto* p = dynamic_cast<const BullCallSpread*>(&product)) {
+        legs.push_back({owner, LegKind::Call, p->lowerStrike(), 1.0});
+        legs.push_back({owner, LegKind::Call, p->upperStrike(), -1.0});
+    } else if (auto* p = dynamic_cast<const BearPutSpread*>(&product)) {
+        legs.push_back({owner, LegKind::Put, p->upperStrike(), 1.0});
+        legs.push_back({owner, LegKind::Put, p->lowerStrike(), -1.0});
+    } else if (auto* p = dynamic_cast<const Straddle*>(&product)) {
+        legs.push_back({owner, LegKind::Call, p->strike(), 1.0});
+        legs.push_back({owner, LegKind::Put, p->strike(), 1.0});
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+bool AnalyticBsPricer::supports(const InterfaceProducts& product)
+{
+    std::vector<Leg> legs;
+    return decompose(product, 0, legs);
+}
+
+AnalyticBsPricer::Result AnalyticBsPricer::price(const InterfaceProducts& product,
+                                                const BlackScholesModel& model,
+                                                double S0) const
+{
+    return priceBatch({&product}, model, S0).front();
+}
+
+std::vector<AnalyticBsPricer::Result>
+AnalyticBsPricer::priceBatch(const std::vector<const InterfaceProducts*>& products,
+                             const BlackScholesModel& model,
+                             double S0) const
+{
+    if (S0 <= 0.0) throw std::invalid_argument("S0 must be > 0 for closed-form pricing.");
+
+    const int N = static_cast<int>(products.size());
+
+    std::vector<Leg> legs;
+    legs.reserve(2 * N);
+    for (int k = 0; k < N; ++k) {
+        if (!products[k] || !decompose(*products[k], k, legs))
+            throw std::invalid_argument("Product has no closed-form Black-Scholes price.");
+    }
+
+    const double r = model.r();
+    const double q = model.q();
+    const double sigma = model.sigma();
+    const int L = static_cast<int>(legs.size());
+
+    // Arguments of every CDF evaluation: N(phi*d1) at [2l], N(phi*d2) at [2l+1]
+    std::vector<double> args(2 * L), cdfs(2 * L);
+    std::vector<double> d1(L), volSqrtT(L);
+
+    for (int l = 0; l < L; ++l) {
+        const Leg& leg = legs[l];
+        const double T = products[leg.owner]->maturity();
+
+        // sigma*sqrt(T) -> 0 gives d = +-inf: the formulas tend to intrinsic value
+        volSqrtT[l] = std::max(sigma * std::sqrt(T), 1e-300);
+        d1[l] = (std::log(S0 / leg.K) + (r - q + 0.5 * sigma * sigma) * T) / volSqrtT[l];
+        const double d2 = d1[l] - volSqrtT[l];
+
+        const double phi = (leg.kind == LegKind::Put) ? -1.0 : 1.0;
+        args[2 * l]     = phi * d1[l];
+        args[2 * l + 1] = phi * d2;
+    }
+
+    normal::cdf(args.data(), cdfs.data(), 2 * L);
+
+    std::vector<Result> results(N);
+    for (auto& res : results) {
+        res.price = 0.0;
+        res.delta = 0.0;
+        res.gamma = 0.0;
+    }
+
+    for (int l = 0; l < L; ++l) {
+        const Leg& leg = legs[l];
+        const double T = products[leg.owner]->maturity();
+        const double dq = std::exp(-q * T);
+        const double dr = std::exp(-r * T);
+        Result& res = results[leg.owner];
+
+        if (leg.kind == LegKind::Forward) {
+            res.price += leg.weight * (S0 * dq - leg.K * dr);
+            res.delta += leg.weight * dq;
+            continue;
+        }
+
+        const double phi = (leg.kind == LegKind::Put) ? -1.0 : 1.0;
+        res.price += leg.weight * phi * (S0 * dq * cdfs[2 * l] - leg.K * dr * cdfs[2 * l + 1]);
+        res.delta += leg.weight * phi * dq * cdfs[2 * l];
+        res.gamma += leg.weight * dq * normal::pdf(d1[l]) / (S0 * volSqrtT[l]);
+    }
+
+    return results;
+}
+
+double AnalyticBsPricer::exchangeOption(const TwoAssetModel& model, double S1, double S2, double T)
+{
+    const double F1 = S1 * std::exp(-model.q1() * T);
+    const double F2 = S2 * std::exp(-model.q2() * T);
+    const double s1 = model.sigma1();
+    const double s2 = model.sigma2();
+    const double sig = std::sqrt(std::max(s1 * s1 + s2 * s2 - 2.0 * model.rho() * s1 * s2, 0.0));
+
+    if (sig * std::sqrt(T) <= 0.0) return std::max(F1 - F2, 0.0);
+
+    const double d1 = (std::log(F1 / F2) + 0.5 * sig * sig * T) / (sig * std::sqrt(T));
+    const double d2 = d1 - sig * std::sqrt(T);
+    return F1 * normal::cdf(d1) - F2 * normal::cdf(d2);
+}
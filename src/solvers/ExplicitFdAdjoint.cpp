@@ -0,0 +1,149 @@
+#include "ExplicitFdSolver.hpp"
+#include "ExplicitFdInterpolation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+ExplicitFdSolver::AdjointResult ExplicitFdSolver::priceAdjoint(const InterfaceProducts& option,
+                                                              const BlackScholesModel& model,
+                                                              const FdGrid& grid,
+                                                              double S0,
+                                                              int checkpointInterval) const
+{
+    validateGrid(grid);
+    validateBarrier(option, grid);
+    if (checkpointInterval < 0) throw std::invalid_argument("checkpointInterval must be >= 0.");
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const double dt = grid.dt();
+    const auto& S = grid.priceGrid();
+    const bool american = option.isAmerican();
+
+    const int k = (checkpointInterval > 0)
+        ? std::min(checkpointInterval, Nt)
+        : std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(Nt)))));
+
+    const Coefficients coef = coefficients(model, grid);
+    const fd_kernel::Stencil st{coef.A.data(), coef.B.data(), coef.C.data()};
+
+    std::vector<double> left(Nt), right(Nt);
+    fd_kernel::boundaryValues(option, grid, left.data(), right.data());
+
+    std::vector<double> exercise;
+    if (american) {
+        exercise.resize(Ns + 1);
+        for (int i = 0; i <= Ns; ++i) exercise[i] = option.earlyExerciseValue(S[i]);
+    }
+
+    // One explicit step V^n = M V^{n+1}, same kernels as price()
+    auto step = [&](int n, const double* v, double* out) {
+        out[0]  = left[n];
+        out[Ns] = right[n];
+        if (american) kernels_->stepAmerican(st.A, st.B, st.C, v, exercise.data(), out, 1, Ns);
+        else          kernels_->step(st.A, st.B, st.C, v, out, 1, Ns);
+    };
+
+    // 1) Forward rollback, keeping V^m at m = Nt, Nt - k, Nt - 2k, ...
+    std::vector<std::vector<double>> checkpoint;
+    std::vector<double> V(Ns + 1), Vnew(Ns + 1);
+    for (int i = 0; i <= Ns; ++i) V[i] = option.payoff(S[i]);
+
+    for (int n = Nt - 1; n >= 0; --n) {
+        if ((Nt - 1 - n) % k == 0) checkpoint.push_back(V);
+        step(n, V.data(), Vnew.data());
+        V.swap(Vnew);
+    }
+
+    AdjointResult out;
+    out.checkpoints = static_cast<int>(checkpoint.size());
+
+    // d(coefficients)/d(sigma) and d/d(mu), mu = r - q; d/dr adds -dt on B
+    const double sigma = model.sigma();
+    std::vector<double> As(Ns + 1, 0.0), Bs(Ns + 1, 0.0), Cs(Ns + 1, 0.0);
+    std::vector<double> Am(Ns + 1, 0.0), Bm(Ns + 1, 0.0), Cm(Ns + 1, 0.0);
+    for (int i = 1; i < Ns; ++i) {
+        const FdGrid::Weights d = grid.weights(i);
+        const double s2 = dt * sigma * S[i] * S[i];
+        const double s1 = dt * S[i];
+        As[i] = s2 * d.d2m;  Bs[i] = s2 * d.d2c;  Cs[i] = s2 * d.d2p;
+        Am[i] = s1 * d.d1m;  Bm[i] = s1 * d.d1c;  Cm[i] = s1 * d.d1p;
+    }
+
+    // 2) Reverse sweep: lambda^n = dPrice/dV^n on interior nodes (boundary
+    //    values are fixed data), from t=0 up to maturity, seeded with the
+    //    interpolation weights of makeResult
+    double x;
+    int ip;
+    fd_interp::bracket(grid, &S0, &x, &ip, 1);
+    const double w = fd_interp::weight(grid, x, ip);
+
+    std::vector<double> lambda(Ns + 1, 0.0), lambdaNext(Ns + 1, 0.0);
+    if (ip > 0)      lambda[ip]     = 1.0 - w;
+    if (ip + 1 < Ns) lambda[ip + 1] = w;
+
+    std::vector<double> gSigma(Ns + 1, 0.0), gMu(Ns + 1, 0.0), gV(Ns + 1, 0.0);
+    double priceNext = 0.0;
+
+    std::vector<std::vector<double>> segment;
+    for (int c = out.checkpoints - 1; c >= 0; --c) {
+        // Recompute the states of this segment: V^{top}, ..., V^{lo}
+        const int top = Nt - c * k;
+        const int lo  = std::max(top - k, 0);
+
+        segment.resize(top - lo + 1);
+        segment[0] = checkpoint[c];
+        for (int m = top - 1, j = 1; m >= lo; --m, ++j) {
+            segment[j].resize(Ns + 1);
+            step(m, segment[j - 1].data(), segment[j].data());
+        }
+
+        // Theta: V^1 interpolated at S0 (first time step)
+        if (lo == 0 && Nt >= 1) {
+            const std::vector<double>& V1 = segment[top - lo - 1];
+            priceNext = (1.0 - w) * V1[ip] + w * V1[ip + 1];
+        }
+
+        // Steps n = lo .. top-1 in increasing order: V^n = M V^{n+1}
+        for (int n = lo; n < top; ++n) {
+            const double* v = segment[top - (n + 1)].data(); // V^{n+1}
+
+            // Exercised nodes do not depend on V^{n+1}; per-node accumulators
+            // keep the loop free of serial reductions
+            for (int i = 1; i < Ns; ++i) {
+                double l = lambda[i];
+                if (american) {
+                    const double val = st.A[i] * v[i - 1] + st.B[i] * v[i] + st.C[i] * v[i + 1];
+                    l = (val < exercise[i]) ? 0.0 : l;
+                    lambda[i] = l;
+                }
+                gSigma[i] += l * (As[i] * v[i - 1] + Bs[i] * v[i] + Cs[i] * v[i + 1]);
+                gMu[i]    += l * (Am[i] * v[i - 1] + Bm[i] * v[i] + Cm[i] * v[i + 1]);
+                gV[i]     += l * v[i];
+            }
+
+            // lambda^{n+1} = M^T lambda^n on interior nodes (lambda and the
+            // coefficients are 0 on the boundary nodes)
+            for (int j = 1; j < Ns; ++j) {
+                lambdaNext[j] = st.A[j + 1] * lambda[j + 1] + st.B[j] * lambda[j] + st.C[j - 1] * lambda[j - 1];
+            }
+            lambda.swap(lambdaNext);
+        }
+    }
+
+    double sumSigma = 0.0, sumMu = 0.0, sumV = 0.0;
+    for (int i = 1; i < Ns; ++i) {
+        sumSigma += gSigma[i];
+        sumMu    += gMu[i];
+        sumV     += gV[i];
+    }
+
+    out.result = makeResult(grid, std::move(V), S0);
+    out.vega    = sumSigma;
+    out.rho     = sumMu - dt * sumV;
+    out.epsilon = -sumMu;
+    out.theta   = (priceNext - out.result.price) / dt;
+    return out;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include "../grid/FdGrid.hpp"
+#include "StencilKernels.hpp"
+
+/**
+ * Evaluation of a value surface V0 at arbitrary spots, shared by
+ * ExplicitFdSolver::makeResult / ladder and the adjoint seed (internal)
+ * Spots are clamped strictly inside the grid and bracketed by the nodes
+ * i, i+1 with i in [0, Ns-1]; the price is interpolated linearly and the
+ * Greeks are central differences at the bracketing node.
+ */
+namespace fd_interp {
+
+// Spot clamped strictly inside the grid to avoid boundary issues for Greeks
+inline double clampInside(const std::vector<double>& S, double x)
+{
+    if (x <= S.front()) x = S.front() + 1e-12;
+    if (x >= S.back())  x = S.back()  - 1e-12;
+    return x;
+}
+
+// Spots clamped inside the grid (x) and their bracketing nodes i in
+// [0, Ns-1], S[i] <= x <= S[i+1]. Uniform grid: the SIMD bracket kernel
+// (direct index and a one-node correction for rounding, x = S.back() when
+// the clamp rounds back onto it); otherwise binary search
+inline void bracket(const FdGrid& grid, const double* spots, double* x, int* idx, int n)
+{
+    const auto& S = grid.priceGrid();
+    const int Ns = grid.Ns();
+
+    if (grid.uniform()) {
+        stencil::bestKernels().bracket(S.data(), Ns, grid.dS(), spots, x, idx, n);
+        return;
+    }
+    for (int m = 0; m < n; ++m) {
+        x[m] = clampInside(S, spots[m]);
+        const int i = static_cast<int>(std::upper_bound(S.begin(), S.end(), x[m]) - S.begin()) - 1;
+        idx[m] = std::min(std::max(i, 0), Ns - 1);
+    }
+}
+
+// Weight of node i+1 in the interpolation at x: P = (1-w) V[i] + w V[i+1]
+inline double weight(const FdGrid& grid, double x, int i)
+{
+    const auto& S = grid.priceGrid();
+    return (x - S[i]) / (S[i + 1] - S[i]);
+}
+
+// Linear interpolation of the price between the bracketing nodes
+inline double interpolatePrice(const FdGrid& grid, const double* V, double x, int i)
+{
+    const double w = weight(grid, x, i);
+    return (1.0 - w) * V[i] + w * V[i + 1];
+}
+
+// Central-difference Greeks at the bracketing node (kept away from the
+// boundaries)
+inline void greeks(const FdGrid& grid, const double* V, int i, double& delta, double& gamma)
+{
+    const int j = std::min(std::max(i, 1), grid.Ns() - 1);
+    if (grid.uniform()) {
+        const double dS = grid.dS();
+        delta = (V[j + 1] - V[j - 1]) / (2.0 * dS);
+        gamma = (V[j + 1] - 2.0 * V[j] + V[j - 1]) / (dS * dS);
+    } else {
+        const FdGrid::Weights d = grid.weights(j);
+        delta = d.d1m * V[j - 1] + d.d1c * V[j] + d.d1p * V[j + 1];
+        gamma = d.d2m * V[j - 1] + d.d2c * V[j] + d.d2p * V[j + 1];
+    }
+}
+
+inline void evaluate(const FdGrid& grid, const double* V,
+                     double x, int i, double& price, double& delta, double& gamma)
+{
+    price = interpolatePrice(grid, V, x, i);
+    greeks(grid, V, i, delta, gamma);
+}
+
+} // namespace fd_interp
@@ -0,0 +1,450 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include "../parallel/ThreadPool.hpp"
+
+/**
+ * Compile-time kernels of the explicit scheme.
+ * Instantiated per concrete (final) product type so that payoff, boundaries
+ * and the early-exercise obstacle are resolved statically and inlined;
+ * the time steps themselves run on the runtime-selected SIMD stencil.
+ * All loops work on raw buffers (from a SolverWorkspace).
+ */
+namespace fd_kernel {
+
+// Stencil coefficient arrays A, B, C (indexed by node)
+struct Stencil {
+    const double* A;
+    const double* B;
+    const double* C;
+};
+
+// A node is exercised when the American step took a positive exercise
+// value (ties with a zero payoff, e.g. far out of the money, are not)
+inline bool isExercised(double v, double obstacle)
+{
+    return v == obstacle && obstacle > 0.0;
+}
+
+// Exercised nodes of [begin, end)
+inline std::int64_t countExercised(const double* v, const double* obstacle, int begin, int end)
+{
+    int n = 0;
+    for (int i = begin; i < end; ++i) n += isExercised(v[i], obstacle[i]) ? 1 : 0;
+    return n;
+}
+
+// Dirichlet values at Smin / Smax for every time level t_n, n = 0..Nt-1,
+// evaluated once before the rollback instead of inside it
+template <class Product>
+void boundaryValues(const Product& option, const FdGrid& grid, double* left, double* right)
+{
+    const int Nt = grid.Nt();
+    const double Smax = grid.priceGrid().back();
+
+    for (int n = 0; n < Nt; ++n) {
+        const double tn = grid.time(n);
+        left[n]  = option.leftBoundary(tn);
+        right[n] = option.rightBoundary(tn, Smax);
+    }
+}
+
+// Backward time stepping from V = V(T) to V(0) with the SIMD stencil
+// kernels. European instantiations contain no obstacle at all; American
+// ones apply a vectorized max() against the precomputed obstacle.
+// V and Vnew are used as ping-pong buffers; returns the one holding V(0).
+template <bool American>
+double* explicitRollback(const stencil::Kernels& kernels,
+                         const Stencil& st,
+                         const double* left,
+                         const double* right,
+                         const double* obstacle,
+                         int Ns, int Nt,
+                         double* V,
+                         double* Vnew,
+                         std::int64_t* exercised = nullptr)
+{
+    for (int n = Nt - 1; n >= 0; --n) {
+        Vnew[0]  = left[n];
+        Vnew[Ns] = right[n];
+
+        if constexpr (American) {
+            kernels.stepAmerican(st.A, st.B, st.C, V, obstacle, Vnew, 1, Ns);
+            if constexpr (solver_stats::kEnabled) {
+                if (exercised) *exercised += countExercised(Vnew, obstacle, 1, Ns);
+            }
+        } else {
+            kernels.step(st.A, st.B, st.C, V, Vnew, 1, Ns);
+        }
+
+        std::swap(V, Vnew);
+    }
+    return V;
+}
+
+// Nodes beyond the previous boundary where the obstacle is still applied
+constexpr int kBoundaryMargin = 2;
+
+// True if no interior stencil coefficient is negative: each step is then a
+// non-negative combination of the previous values and of the Dirichlet
+// values, and non-negative payoffs stay non-negative. Fails where the drift
+// dominates the diffusion (C_i < 0 when r - q < -sigma^2 i, A_i < 0 when
+// r - q > sigma^2 i), typically on the first nodes of a uniform grid.
+inline bool isMonotone(const Stencil& st, int Ns)
+{
+    for (int i = 1; i < Ns; ++i)
+        if (st.A[i] < 0.0 || st.B[i] < 0.0 || st.C[i] < 0.0) return false;
+    return true;
+}
+
+// American rollback for a product whose exercise region lies on one side of
+// a moving boundary S*(t) (Side = -1: S <= S*, puts; +1: S >= S*, calls).
+// Each step runs the fused obstacle kernel only from the grid edge to the
+// previous boundary plus kBoundaryMargin nodes and the European kernel on
+// the rest, growing the obstacle range node by node for as long as its
+// last node is exercised: the obstacle reads and the max() are skipped on
+// the whole continuation region. A node the full sweep would exercise is
+// connected to the range, and outside the range the obstacle never exceeds
+// the continuation value (a zero payoff against non-negative values), so
+// results are identical to explicitRollback<true>. That only holds for a
+// monotone stencil (isMonotone): otherwise the continuation value can dip
+// slightly below zero on the far side, and the obstacle is applied on the
+// whole interior at every step (same results and boundary, no skipping).
+// boundary[n] receives S*(t_n), the outermost exercised node (NaN if none).
+template <int Side>
+double* trackedRollback(const stencil::Kernels& kernels,
+                        const Stencil& st,
+                        const double* left,
+                        const double* right,
+                        const double* obstacle,
+                        const double* S,
+                        int Ns, int Nt,
+                        double* V,
+                        double* Vnew,
+                        double* boundary,
+                        std::int64_t* exercised = nullptr)
+{
+    static_assert(Side == -1 || Side == 1, "Side is -1 (put-like) or +1 (call-like)");
+
+    // Range [lo, hi) of nodes given the obstacle; the whole interior at first
+    // (and throughout if the stencil is not monotone)
+    const bool track = isMonotone(st, Ns);
+    int lo = 1, hi = Ns;
+
+    for (int n = Nt - 1; n >= 0; --n) {
+        Vnew[0]  = left[n];
+        Vnew[Ns] = right[n];
+
+        int b = -1;
+        if constexpr (Side < 0) {
+            kernels.stepAmerican(st.A, st.B, st.C, V, obstacle, Vnew, 1, hi);
+            kernels.step(st.A, st.B, st.C, V, Vnew, hi, Ns);
+            int i = hi;
+            for (; i < Ns && isExercised(Vnew[i - 1], obstacle[i - 1]); ++i)
+                Vnew[i] = std::max(Vnew[i], obstacle[i]);  // grow while the edge is exercised
+            hi = i;
+            for (i = hi - 1; i >= 1 && b < 0; --i)
+                if (isExercised(Vnew[i], obstacle[i])) b = i;
+            if (track) hi = std::min((b < 0 ? 0 : b) + 1 + kBoundaryMargin, Ns);
+        } else {
+            kernels.stepAmerican(st.A, st.B, st.C, V, obstacle, Vnew, lo, Ns);
+            kernels.step(st.A, st.B, st.C, V, Vnew, 1, lo);
+            int i = lo - 1;
+            for (; i >= 1 && isExercised(Vnew[i + 1], obstacle[i + 1]); --i)
+                Vnew[i] = std::max(Vnew[i], obstacle[i]);
+            lo = i + 1;
+            for (i = lo; i < Ns && b < 0; ++i)
+                if (isExercised(Vnew[i], obstacle[i])) b = i;
+            if (track) lo = std::max((b < 0 ? Ns : b) - kBoundaryMargin, 1);
+        }
+        boundary[n] = (b < 0) ? std::numeric_limits<double>::quiet_NaN() : S[b];
+
+        if constexpr (solver_stats::kEnabled) {
+            if (exercised) *exercised += (b < 0) ? 0
+                : (Side < 0) ? countExercised(Vnew, obstacle, 1, b + 1)
+                             : countExercised(Vnew, obstacle, b, Ns);
+        }
+
+        std::swap(V, Vnew);
+    }
+    return V;
+}
+
+// Temporally blocked (time-skewed) rollback: the time steps are grouped in
+// blocks of `depth` steps, and each block advances the grid tile by tile.
+// A tile of `width` output nodes is loaded with a halo of `depth` nodes on
+// each side into two small scratch buffers (size >= width + 2*depth + 2),
+// stepped `depth` times while cache-resident (the valid region shrinking by
+// one node per side and step, i.e. a trapezoid), and only its final values
+// are written back.
+// Dirichlet values are imposed whenever the halo reaches S=Smin or S=Smax,
+// and the obstacle is applied at every step, so every node runs the same
+// arithmetic as explicitRollback and results are identical; V/Vnew traffic
+// drops by a factor of about `depth`.
+template <bool American>
+double* tiledRollback(const stencil::Kernels& kernels,
+                      const Stencil& st,
+                      const double* left,
+                      const double* right,
+                      const double* obstacle,
+                      int Ns, int Nt,
+                      double* V,
+                      double* Vnew,
+                      int depth,
+                      int width,
+                      double* scratchA,
+                      double* scratchB,
+                      std::int64_t* exercised = nullptr)
+{
+    for (int nTop = Nt - 1; nTop >= 0; nTop -= depth) {
+        const int k = std::min(depth, nTop + 1); // steps nTop, ..., nTop-k+1
+
+        for (int a = 1; a < Ns; a += width) {
+            const int b = std::min(a + width, Ns); // output nodes [a, b)
+
+            // Region held in scratch: global nodes [g0, g1)
+            const int g0 = std::max(a - k, 0);
+            const int g1 = std::min(b + k, Ns + 1);
+            std::copy(V + g0, V + g1, scratchA);
+
+            double* v = scratchA;
+            double* out = scratchB;
+
+            for (int s = 0; s < k; ++s) {
+                const int n = nTop - s;
+
+                // Nodes still computable after s+1 steps
+                const int lo = std::max(a - k + s + 1, 1);
+                const int hi = std::min(b + k - s - 1, Ns);
+
+                if (g0 == 0)      out[0] = left[n];
+                if (g1 == Ns + 1) out[Ns - g0] = right[n];
+
+                if constexpr (American) {
+                    kernels.stepAmerican(st.A + g0, st.B + g0, st.C + g0,
+                                         v, obstacle + g0, out, lo - g0, hi - g0);
+                    if constexpr (solver_stats::kEnabled) {
+                        // Halo nodes are recomputed by the neighbour tiles:
+                        // count this tile's own nodes only
+                        if (exercised) *exercised += countExercised(out - g0, obstacle,
+                                                                    std::max(lo, a), std::min(hi, b));
+                    }
+                } else {
+                    kernels.step(st.A + g0, st.B + g0, st.C + g0, v, out, lo - g0, hi - g0);
+                }
+                std::swap(v, out);
+            }
+
+            std::copy(v + (a - g0), v + (b - g0), Vnew + a);
+        }
+
+        const int nLast = nTop - k + 1;
+        Vnew[0]  = left[nLast];
+        Vnew[Ns] = right[nLast];
+        std::swap(V, Vnew);
+    }
+    return V;
+}
+
+// Same rollback with the interior S-range split into one contiguous chunk per
+// pool participant and a barrier after each time step. Every node runs the
+// same kernel arithmetic as the serial loop, so results are identical.
+// V/Vnew (and the obstacle) are allocated here, uninitialized, and first
+// touched by the participant that updates them (NUMA-friendly placement),
+// which is why this path does not use the workspace value buffers.
+template <bool American, class Payoff, class Obstacle>
+std::vector<double> parallelRollback(ThreadPool& pool,
+                                     const stencil::Kernels& kernels,
+                                     const Stencil& st,
+                                     const double* left,
+                                     const double* right,
+                                     int Ns, int Nt,
+                                     Payoff&& payoff,
+                                     Obstacle&& obstacle,
+                                     std::int64_t* exercised = nullptr)
+{
+    const int P = pool.size();
+    std::atomic<std::int64_t> exercisedTotal(0);
+
+    std::unique_ptr<double[]> bufV(new double[Ns + 1]);
+    std::unique_ptr<double[]> bufVnew(new double[Ns + 1]);
+    std::unique_ptr<double[]> exercise(American ? new double[Ns + 1] : nullptr);
+
+    // Chunk p covers [chunkBegin(p), chunkBegin(p+1)), cut on 8-node boundaries
+    auto chunkBegin = [&](int p) {
+        if (p == 0) return 1;
+        if (p == P) return Ns;
+        const int b = static_cast<int>(static_cast<long long>(Ns - 1) * p / P + 1) & ~7;
+        return std::min(std::max(b, 1), Ns);
+    };
+
+    SpinBarrier barrier(P);
+
+    pool.run([&](int p) {
+        const int begin = chunkBegin(p);
+        const int end   = chunkBegin(p + 1);
+
+        // First touch: terminal payoff (and obstacle) on this participant's nodes
+        const int lo = (p == 0) ? 0 : begin;
+        const int hi = (p == P - 1) ? Ns + 1 : end;
+        for (int i = lo; i < hi; ++i) {
+            bufV[i] = payoff(i);
+            bufVnew[i] = 0.0;
+            if constexpr (American) exercise[i] = obstacle(i);
+        }
+        barrier.arriveAndWait();
+
+        double* v = bufV.get();
+        double* out = bufVnew.get();
+        std::int64_t exercisedLocal = 0;
+
+        for (int n = Nt - 1; n >= 0; --n) {
+            if (p == 0)     out[0]  = left[n];
+            if (p == P - 1) out[Ns] = right[n];
+
+            if (begin < end) {
+                if constexpr (American) {
+                    kernels.stepAmerican(st.A, st.B, st.C, v, exercise.get(), out, begin, end);
+                    if constexpr (solver_stats::kEnabled) {
+                        if (exercised) exercisedLocal += countExercised(out, exercise.get(), begin, end);
+                    }
+                } else {
+                    kernels.step(st.A, st.B, st.C, v, out, begin, end);
+                }
+            }
+
+            barrier.arriveAndWait();
+            std::swap(v, out);
+        }
+        if constexpr (solver_stats::kEnabled) exercisedTotal.fetch_add(exercisedLocal, std::memory_order_relaxed);
+    });
+    if (exercised) *exercised += exercisedTotal.load();
+
+    const double* V0 = (Nt % 2 == 0) ? bufV.get() : bufVnew.get();
+    return std::vector<double>(V0, V0 + Ns + 1);
+}
+
+} // namespace fd_kernel
+
+template <bool American>
+const double* ExplicitFdSolver::rollback(const FdGrid& grid, SolverWorkspace& ws, std::int64_t* exercised,
+                                         int exerciseSide) const
+{
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const fd_kernel::Stencil st{ws.A.data(), ws.B.data(), ws.C.data()};
+
+    if constexpr (American) {
+        if (exerciseSide != 0 && tileDepth_ <= 1) {
+            ws.prepareBoundary(Nt);
+            const double* S = grid.priceGrid().data();
+            return exerciseSide < 0
+                ? fd_kernel::trackedRollback<-1>(*kernels_, st, ws.left.data(), ws.right.data(), ws.obstacle.data(),
+                                                 S, Ns, Nt, ws.V.data(), ws.Vnew.data(), ws.boundary.data(), exercised)
+                : fd_kernel::trackedRollback<1>(*kernels_, st, ws.left.data(), ws.right.data(), ws.obstacle.data(),
+                                                S, Ns, Nt, ws.V.data(), ws.Vnew.data(), ws.boundary.data(), exercised);
+        }
+    }
+
+    if (tileDepth_ > 1) {
+        ws.prepareScratch(tileWidth_ + 2 * tileDepth_ + 2);
+        return fd_kernel::tiledRollback<American>(*kernels_, st, ws.left.data(), ws.right.data(),
+                                                  ws.obstacle.data(), Ns, Nt, ws.V.data(), ws.Vnew.data(),
+                                                  tileDepth_, tileWidth_,
+                                                  ws.scratchA.data(), ws.scratchB.data(), exercised);
+    }
+    return fd_kernel::explicitRollback<American>(*kernels_, st, ws.left.data(), ws.right.data(),
+                                                 ws.obstacle.data(), Ns, Nt, ws.V.data(), ws.Vnew.data(),
+                                                 exercised);
+}
+
+template <class Product>
+ExplicitFdSolver::Result ExplicitFdSolver::priceProduct(const Product& option,
+                                                       const BlackScholesModel& model,
+                                                       const FdGrid& grid,
+                                                       double S0) const
+{
+    return priceProduct(option, model, grid, S0, SolverWorkspace::threadLocal());
+}
+
+template <class Product>
+ExplicitFdSolver::Result ExplicitFdSolver::priceProduct(const Product& option,
+                                                       const BlackScholesModel& model,
+                                                       const FdGrid& grid,
+                                                       double S0,
+                                                       SolverWorkspace& ws,
+                                                       bool keepV0) const
+{
+    static_assert(std::is_base_of<InterfaceProducts, Product>::value,
+                  "priceProduct requires an InterfaceProducts implementation.");
+    static_assert(std::is_final<Product>::value,
+                  "priceProduct requires a final product type (use price() otherwise).");
+
+    validateGrid(grid);
+    validateBarrier(option, grid);
+    solver_stats::Timer timer;
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const auto& S = grid.priceGrid();
+
+    ws.prepare(Ns + 1, Nt);
+    coefficients(model, grid, ws.A.data(), ws.B.data(), ws.C.data());
+    fd_kernel::boundaryValues(option, grid, ws.left.data(), ws.right.data());
+    const double setupSeconds = timer.lap();
+    std::int64_t exercised = 0;
+
+    if (useThreadPool(Ns)) {
+        // Payoff and obstacle are initialized inside the parallel rollback
+        const fd_kernel::Stencil st{ws.A.data(), ws.B.data(), ws.C.data()};
+        std::vector<double> V0 = fd_kernel::parallelRollback<Product::kAmerican>(
+            *pool_, *kernels_, st, ws.left.data(), ws.right.data(), Ns, Nt,
+            [&](int i) { return option.payoff(S[i]); },
+            [&](int i) { return option.earlyExerciseValue(S[i]); },
+            &exercised);
+        const double rollbackSeconds = timer.lap();
+        ws.setValues(nullptr, 0);
+        Result res = makeResult(grid, std::move(V0), S0);
+        if constexpr (solver_stats::kEnabled) {
+            fillStats(res.stats, grid, Product::kAmerican, exercised,
+                      setupSeconds, 0.0, rollbackSeconds, timer.total());
+        }
+        return res;
+    }
+
+    // Terminal condition: V(T,S)=payoff(S)
+    double* V = ws.V.data();
+    for (int i = 0; i <= Ns; ++i) {
+        V[i] = option.payoff(S[i]);
+    }
+
+    if constexpr (Product::kAmerican) {
+        // Obstacle is time-independent: inlined evaluation once per node
+        double* exercise = ws.obstacle.data();
+        for (int i = 0; i <= Ns; ++i) exercise[i] = option.earlyExerciseValue(S[i]);
+    }
+    const double payoffSeconds = timer.lap();
+
+    const double* V0 = rollback<Product::kAmerican>(grid, ws, &exercised, option.exerciseSide());
+    const double rollbackSeconds = timer.lap();
+
+    ws.setValues(V0, Ns + 1);
+    Result res = makeResult(grid, V0, S0, keepV0);
+    if constexpr (Product::kAmerican) {
+        if (keepV0 && option.exerciseSide() != 0 && tileDepth_ <= 1)
+            res.exerciseBoundary.assign(ws.boundary.data(), ws.boundary.data() + Nt);
+    }
+    if constexpr (solver_stats::kEnabled) {
+        fillStats(res.stats, grid, Product::kAmerican, exercised,
+                  setupSeconds, payoffSeconds, rollbackSeconds, timer.total());
+    }
+    return res;
+}
@@ -0,0 +1,149 @@
+#include "ExplicitFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Backward time stepping on float values: Dirichlet values rounded to
+// float, interior advanced by step(v, out) (float or mixed kernel). V and
+// Vnew are ping-pong buffers; returns the one holding V(0).
+template <class Step>
+const float* rollbackFloat(Step step, const double* left, const double* right,
+                           int Ns, int Nt, float* V, float* Vnew)
+{
+    for (int n = Nt - 1; n >= 0; --n) {
+        Vnew[0]  = static_cast<float>(left[n]);
+        Vnew[Ns] = static_cast<float>(right[n]);
+        step(V, Vnew);
+        std::swap(V, Vnew);
+    }
+    return V;
+}
+
+double seconds(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
+
+} // namespace
+
+ExplicitFdSolver::Result ExplicitFdSolver::priceReduced(const InterfaceProducts& option,
+                                                        const BlackScholesModel& model,
+                                                        const FdGrid& grid,
+                                                        double S0,
+                                                        SolverWorkspace& ws,
+                                                        bool keepV0) const
+{
+    validateGrid(grid);
+    validateBarrier(option, grid);
+    solver_stats::Timer timer;
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const auto& S = grid.priceGrid();
+    const bool american = option.isAmerican();
+    const bool floatCoefficients = precision_ == Precision::Float;
+
+    ws.prepare(Ns + 1, Nt);
+    ws.prepareFloat(Ns + 1, floatCoefficients);
+    coefficients(model, grid, ws.A.data(), ws.B.data(), ws.C.data());
+    fd_kernel::boundaryValues(option, grid, ws.left.data(), ws.right.data());
+
+    if (floatCoefficients) {
+        // D = 1 - (A + B + C) = r dt, taken in double before rounding
+        for (int i = 0; i <= Ns; ++i) {
+            ws.Af[i] = static_cast<float>(ws.A[i]);
+            ws.Cf[i] = static_cast<float>(ws.C[i]);
+            ws.Df[i] = static_cast<float>(1.0 - (ws.A[i] + ws.B[i] + ws.C[i]));
+        }
+    }
+    const double setupSeconds = timer.lap();
+
+    // Terminal condition and obstacle
+    for (int i = 0; i <= Ns; ++i) ws.Vf[i] = static_cast<float>(option.payoff(S[i]));
+    if (american) {
+        for (int i = 0; i <= Ns; ++i) ws.obstacle[i] = option.earlyExerciseValue(S[i]);
+        if (floatCoefficients) {
+            for (int i = 0; i <= Ns; ++i) ws.obstaclef[i] = static_cast<float>(ws.obstacle[i]);
+        }
+    }
+    const double payoffSeconds = timer.lap();
+
+    const stencil::Kernels& k = *kernels_;
+    const stencil::FlushDenormals flush;
+    const float* Vf = nullptr;
+    if (floatCoefficients) {
+        const float* A = ws.Af.data();
+        const float* C = ws.Cf.data();
+        const float* D = ws.Df.data();
+        const float* obstacle = ws.obstaclef.data();
+        Vf = american
+            ? rollbackFloat([&](const float* v, float* out) { k.stepFloatAmerican(A, C, D, v, obstacle, out, 1, Ns); },
+                            ws.left.data(), ws.right.data(), Ns, Nt, ws.Vf.data(), ws.Vnewf.data())
+            : rollbackFloat([&](const float* v, float* out) { k.stepFloat(A, C, D, v, out, 1, Ns); },
+                            ws.left.data(), ws.right.data(), Ns, Nt, ws.Vf.data(), ws.Vnewf.data());
+    } else {
+        const double* A = ws.A.data();
+        const double* B = ws.B.data();
+        const double* C = ws.C.data();
+        const double* obstacle = ws.obstacle.data();
+        Vf = american
+            ? rollbackFloat([&](const float* v, float* out) { k.stepMixedAmerican(A, B, C, v, obstacle, out, 1, Ns); },
+                            ws.left.data(), ws.right.data(), Ns, Nt, ws.Vf.data(), ws.Vnewf.data())
+            : rollbackFloat([&](const float* v, float* out) { k.stepMixed(A, B, C, v, out, 1, Ns); },
+                            ws.left.data(), ws.right.data(), Ns, Nt, ws.Vf.data(), ws.Vnewf.data());
+    }
+    const double rollbackSeconds = timer.lap();
+
+    // Price and Greeks in double from the float V(0)
+    double* V0 = ws.V.data();
+    for (int i = 0; i <= Ns; ++i) V0[i] = Vf[i];
+
+    ws.setValues(V0, Ns + 1);
+    Result res = makeResult(grid, V0, S0, keepV0);
+    if constexpr (solver_stats::kEnabled) {
+        fillStats(res.stats, grid, american, 0, setupSeconds, payoffSeconds, rollbackSeconds, timer.total());
+    }
+    return res;
+}
+
+ExplicitFdSolver::PrecisionReport ExplicitFdSolver::checkPrecision(Precision precision,
+                                                                   const std::vector<PrecisionSample>& samples) const
+{
+    ExplicitFdSolver reference = *this;
+    ExplicitFdSolver reduced = *this;
+    reference.setPrecision(Precision::Double);
+    reduced.setPrecision(precision);
+
+    PrecisionReport report;
+    report.precision = precision;
+    report.samples = static_cast<int>(samples.size());
+
+    SolverWorkspace& ws = SolverWorkspace::threadLocal();
+    for (std::size_t k = 0; k < samples.size(); ++k) {
+        const PrecisionSample& s = samples[k];
+        if (!s.option) throw std::invalid_argument("Precision sample without a product.");
+
+        auto t0 = std::chrono::steady_clock::now();
+        const Result a = reference.price(*s.option, s.model, s.grid, s.S0, ws, false);
+        report.doubleSeconds += seconds(t0);
+
+        t0 = std::chrono::steady_clock::now();
+        const Result b = reduced.price(*s.option, s.model, s.grid, s.S0, ws, false);
+        report.reducedSeconds += seconds(t0);
+
+        const double priceError = std::fabs(b.price - a.price);
+        if (report.worstSample < 0 || priceError > report.maxPriceError) {
+            report.maxPriceError = priceError;
+            report.worstSample = static_cast<int>(k);
+        }
+        report.maxDeltaError = std::max(report.maxDeltaError, std::fabs(b.delta - a.delta));
+        report.maxGammaError = std::max(report.maxGammaError, std::fabs(b.gamma - a.gamma));
+    }
+    return report;
+}
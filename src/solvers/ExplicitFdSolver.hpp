@@ -3,6 +3,13 @@
 #include "../grid/FdGrid.hpp"
 #include "../model/BlackScholesModel.hpp"
 #include "../products/InterfaceProducts.hpp"
+#include "StencilKernels.hpp"
+#include "SolverStats.hpp"
+
+class ThreadPool;
+class SolverWorkspace;
+class TermStructureModel;
+class TermStructureGrid;
 
 /**
  * Explicit finite-difference solver for the Black–Scholes PDE
@@ -14,10 +21,270 @@ public:
         double price;           // interpolated price at S0
         double delta;           // delta
         double gamma;           // gamma
+        SolveStats stats;       // counters and phase timings (BS_SOLVER_STATS builds)
+
+        // Early-exercise boundary S*(t_n), n = 0..Nt-1 (NaN where no node is
+        // exercised): American products with a known exerciseSide(), serial
+        // explicit sweep, kept like V0
+        std::vector<double> exerciseBoundary;
     };
 
+    // Uses the best SIMD stencil kernel of the host
+    ExplicitFdSolver();
+
+    // Forces a SIMD level (capped to what the host supports), e.g. Scalar
+    // for the bitwise reference
+    explicit ExplicitFdSolver(stencil::SimdLevel level);
+
+    stencil::SimdLevel simdLevel() const { return kernels_->level; }
+
+    // Splits the interior S-range of each solve across a persistent pool
+    // (nullptr: serial). Grids with fewer than minNodesPerThread interior
+    // nodes per participant stay serial. The pool must outlive the solver.
+    void setThreadPool(ThreadPool* pool, int minNodesPerThread = 1024);
+
+    // Temporal blocking for grids larger than the caches: advances
+    // stepsPerTile time steps per cache-resident tile of tileWidth nodes
+    // before moving on (0 or 1: plain step-by-step sweep). Results are
+    // identical to the plain sweep. Serial path only: a thread pool, when
+    // set and used, takes precedence.
+    void setTemporalBlocking(int stepsPerTile, int tileWidth = 4096);
+
+    // Value type of the explicit sweep in price() on a constant model.
+    // Float: float values and coefficients, in increment form (twice the
+    // SIMD width and half the memory traffic of Double); Mixed: float
+    // values, double coefficients and arithmetic. Reduced precisions run the
+    // serial plain sweep (no pool, tiling or exercise boundary); products
+    // with monitoring dates stay in Double. Price and Greeks are read from
+    // V(0) in double. checkPrecision() measures the cost in accuracy.
+    enum class Precision { Double, Float, Mixed };
+
+    void setPrecision(Precision precision) { precision_ = precision; }
+    Precision precision() const { return precision_; }
+
+    // Products of this library are dispatched to their devirtualized kernel
+    // (priceProduct); user-defined products take the generic virtual path.
+    // Products with barrier monitoring dates are rolled back date to date
+    // (serial sweep, knockOut applied on each date).
+    // Buffers come from the calling thread's SolverWorkspace.
     Result price(const InterfaceProducts& option,
                  const BlackScholesModel& model,
                  const FdGrid& grid,
                  double S0) const;
+
+    // Same with an explicit workspace. With keepV0 = false, Result::V0 is left
+    // empty and the t=0 values are read through ws.values() (valid until the
+    // next solve on ws): no allocation at all once the workspace is warm.
+    Result price(const InterfaceProducts& option,
+                 const BlackScholesModel& model,
+                 const FdGrid& grid,
+                 double S0,
+                 SolverWorkspace& ws,
+                 bool keepV0 = true) const;
+
+    // Term-structure model on its piecewise-uniform grid
+    // (GridParameters::makeGrid): stencil coefficients are rebuilt once per
+    // piece, from the constant segment in force. The product is built once
+    // against a model owned by the solver, which is set before each
+    // boundary evaluation at t to the mean r and q over [t, T], so boundary
+    // values written with exp(-r (T - t)) and exp(-q (T - t)) are exact.
+    // Serial sweep on the calling thread's workspace.
+    Result price(const ProductBuilder& makeProduct,
+                 const TermStructureModel& model,
+                 const TermStructureGrid& grid,
+                 double S0) const;
+
+    // Kernel instantiated for a concrete final product type: branch-free loop
+    // for European products, inlined obstacle for American ones
+    template <class Product>
+    Result priceProduct(const Product& option,
+                        const BlackScholesModel& model,
+                        const FdGrid& grid,
+                        double S0) const;
+
+    template <class Product>
+    Result priceProduct(const Product& option,
+                        const BlackScholesModel& model,
+                        const FdGrid& grid,
+                        double S0,
+                        SolverWorkspace& ws,
+                        bool keepV0 = true) const;
+
+    // Prices several products sharing the same model and grid in one pass.
+    // Values are stored node-major (V[i*N + k] for product k), so the stencil
+    // coefficients of node i are loaded once and applied to N contiguous values.
+    // All products must have the grid maturity.
+    std::vector<Result> priceBatch(const std::vector<const InterfaceProducts*>& options,
+                                   const BlackScholesModel& model,
+                                   const FdGrid& grid,
+                                   double S0) const;
+
+    // Model sensitivities from one adjoint (reverse) sweep
+    struct AdjointResult {
+        Result result;          // same values as price()
+        double vega = 0.0;      // dPrice/dsigma
+        double rho = 0.0;       // dPrice/dr
+        double epsilon = 0.0;   // dPrice/dq
+        double theta = 0.0;     // dPrice/dt from the first time step
+        int checkpoints = 0;    // stored V vectors (memory ~ checkpoints + interval)
+    };
+
+    // Forward rollback storing V every checkpointInterval steps (0: about
+    // sqrt(Nt)), then one reverse sweep that recomputes each segment from its
+    // checkpoint and propagates dPrice/dV back to maturity, accumulating the
+    // derivatives of the stencil coefficients. Exact derivatives of the
+    // discrete price through the coefficients; the product boundary values
+    // (which may also depend on r and q) are held fixed, like a
+    // bump-and-revalue that only bumps the model passed to the solver.
+    // Cost: a few rollbacks (forward, recomputation, reverse) for all of them.
+    AdjointResult priceAdjoint(const InterfaceProducts& option,
+                               const BlackScholesModel& model,
+                               const FdGrid& grid,
+                               double S0,
+                               int checkpointInterval = 0) const;
+
+    // Sample trade of checkPrecision (the product must outlive the call)
+    struct PrecisionSample {
+        const InterfaceProducts* option;
+        BlackScholesModel model;
+        FdGrid grid;
+        double S0;
+    };
+
+    // Largest discrepancies of a reduced precision against Double over the
+    // samples, and the time spent in each
+    struct PrecisionReport {
+        Precision precision = Precision::Double;
+        int samples = 0;
+        double maxPriceError = 0.0;   // max |reduced - Double|
+        double maxDeltaError = 0.0;
+        double maxGammaError = 0.0;
+        int worstSample = -1;         // sample of the largest price error
+        double doubleSeconds = 0.0;
+        double reducedSeconds = 0.0;
+
+        double speedup() const { return reducedSeconds > 0.0 ? doubleSeconds / reducedSeconds : 0.0; }
+    };
+
+    // Prices every sample with Double and with `precision` (same SIMD level,
+    // pool and tiling as this solver), e.g. to decide per desk whether the
+    // reduced precision is acceptable on representative trades
+    PrecisionReport checkPrecision(Precision precision, const std::vector<PrecisionSample>& samples) const;
+
+    // Explicit stencil V_new[i] = A[i] V[i-1] + B[i] V[i] + C[i] V[i+1],
+    // precomputed once per (model, grid)
+    struct Coefficients {
+        std::vector<double> A;
+        std::vector<double> B;
+        std::vector<double> C;
+    };
+
+    static Coefficients coefficients(const BlackScholesModel& model, const FdGrid& grid);
+
+    // Same, written into caller-provided arrays of size >= Ns+1
+    static void coefficients(const BlackScholesModel& model, const FdGrid& grid,
+                             double* A, double* B, double* C);
+
+    // Throws if the grid cannot be used by the explicit scheme
+    static void validateGrid(const FdGrid& grid);
+
+    // Throws if a continuously monitored barrier of the product is not an
+    // end of the grid, or if it has monitoring dates and the caller does
+    // not apply them (monitored = false)
+    static void validateBarrier(const InterfaceProducts& option, const FdGrid& grid, bool monitored = false);
+
+    // Price/Greeks at many spots from a single t=0 solution
+    struct Ladder {
+        std::vector<double> spots;
+        std::vector<double> price;
+        std::vector<double> delta;
+        std::vector<double> gamma;
+    };
+
+    // One rollback, then the whole spot ladder from V0 (e.g. spot-shock
+    // ladders for risk reports cost a single PDE solve)
+    Ladder priceLadder(const InterfaceProducts& option,
+                       const BlackScholesModel& model,
+                       const FdGrid& grid,
+                       const std::vector<double>& spots) const;
+
+    // Ladder from any solver's V0 on this grid; each point matches what
+    // makeResult returns for that spot
+    static Ladder ladder(const FdGrid& grid,
+                         const std::vector<double>& V0,
+                         const std::vector<double>& spots);
+
+    // Builds a Result from the t=0 values: price interpolated at S0,
+    // Delta/Gamma by central differences (shared by every grid solver)
+    static Result makeResult(const FdGrid& grid, std::vector<double> V0, double S0);
+
+    // Same from a raw V0 buffer; copies it into Result::V0 only if keepV0
+    static Result makeResult(const FdGrid& grid, const double* V0, double S0, bool keepV0);
+
+private:
+    const stencil::Kernels* kernels_;
+    ThreadPool* pool_ = nullptr;
+    int minNodesPerThread_ = 1024;
+
+    int tileDepth_ = 0;
+    int tileWidth_ = 4096;
+
+    Precision precision_ = Precision::Double;
+
+    bool useThreadPool(int Ns) const;
+
+    // Serial rollback on the workspace buffers (plain or temporally blocked
+    // sweep); returns the buffer holding V(0). exercised (stats builds,
+    // American only) accumulates the (node, step) pairs where the obstacle won.
+    // With a known exerciseSide the plain sweep tracks the exercise boundary
+    // (into ws.boundary) and applies the obstacle only on its side.
+    template <bool American>
+    const double* rollback(const FdGrid& grid, SolverWorkspace& ws, std::int64_t* exercised = nullptr,
+                           int exerciseSide = 0) const;
+
+    // Solve counters and phase timings (stats builds); interpolation and
+    // Greeks timings are already set by makeResult
+    static void fillStats(SolveStats& stats, const FdGrid& grid, bool american, std::int64_t exercised,
+                          double setupSeconds, double payoffSeconds, double rollbackSeconds,
+                          double totalSeconds);
+
+    // Rollback over the pieces of a piecewise-uniform grid, stencil rebuilt
+    // per piece from the segment in force and knockOut applied on the
+    // product's monitoring dates (piece starts). boundaryModel, when given,
+    // is the model the product refers to: it is set to the mean r and q
+    // over [t, T] before each boundary evaluation.
+    Result rollbackPieces(const InterfaceProducts& option,
+                          const TermStructureModel& model,
+                          const TermStructureGrid& grid,
+                          double S0,
+                          SolverWorkspace& ws,
+                          bool keepV0,
+                          BlackScholesModel* boundaryModel) const;
+
+    // Discretely monitored barrier on a constant model: the grid is cut at
+    // the monitoring dates, with at most grid.dt() per step
+    Result priceMonitored(const InterfaceProducts& option,
+                          const BlackScholesModel& model,
+                          const FdGrid& grid,
+                          double S0,
+                          SolverWorkspace& ws,
+                          bool keepV0) const;
+
+    // Float or Mixed sweep (precision_), serial, on the workspace float buffers
+    Result priceReduced(const InterfaceProducts& option,
+                        const BlackScholesModel& model,
+                        const FdGrid& grid,
+                        double S0,
+                        SolverWorkspace& ws,
+                        bool keepV0) const;
+
+    // Fallback for products without a compile-time policy
+    Result priceGeneric(const InterfaceProducts& option,
+                        const BlackScholesModel& model,
+                        const FdGrid& grid,
+                        double S0,
+                        SolverWorkspace& ws,
+                        bool keepV0) const;
 };
+
+#include "ExplicitFdKernel.hpp"
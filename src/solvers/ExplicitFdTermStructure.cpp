@@ -0,0 +1,129 @@
+#include "ExplicitFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include "../grid/TermStructureGrid.hpp"
+#include "../model/TermStructureModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+ExplicitFdSolver::Result ExplicitFdSolver::price(const ProductBuilder& makeProduct,
+                                                 const TermStructureModel& model,
+                                                 const TermStructureGrid& grid,
+                                                 double S0) const
+{
+    // Boundary model: reassigned before every boundary evaluation
+    BlackScholesModel boundaryModel = model.average(0.0, grid.T());
+    const std::unique_ptr<InterfaceProducts> option = makeProduct(boundaryModel);
+    if (!option) throw std::invalid_argument("Product builder returned null.");
+
+    return rollbackPieces(*option, model, grid, S0, SolverWorkspace::threadLocal(), true, &boundaryModel);
+}
+
+ExplicitFdSolver::Result ExplicitFdSolver::priceMonitored(const InterfaceProducts& option,
+                                                          const BlackScholesModel& model,
+                                                          const FdGrid& grid,
+                                                          double S0,
+                                                          SolverWorkspace& ws,
+                                                          bool keepV0) const
+{
+    validateGrid(grid);
+    const TermStructureModel flat(model);
+    return rollbackPieces(option, flat, TermStructureGrid(grid, flat, grid.dt(), option.monitoringDates()),
+                          S0, ws, keepV0, nullptr);
+}
+
+ExplicitFdSolver::Result ExplicitFdSolver::rollbackPieces(const InterfaceProducts& option,
+                                                          const TermStructureModel& model,
+                                                          const TermStructureGrid& grid,
+                                                          double S0,
+                                                          SolverWorkspace& ws,
+                                                          bool keepV0,
+                                                          BlackScholesModel* boundaryModel) const
+{
+    const double T = grid.T();
+    const int Ns = grid.Ns();
+    const auto& S = grid.priceGrid();
+    const double Smax = S.back();
+
+    if (std::fabs(option.maturity() - T) > 1e-12 * T)
+        throw std::invalid_argument("Product maturity differs from the grid maturity.");
+
+    int maxSteps = 0;
+    for (int k = 0; k < grid.pieces(); ++k) {
+        validateGrid(grid.piece(k));
+        validateBarrier(option, grid.piece(k), true);
+        maxSteps = std::max(maxSteps, grid.piece(k).Nt());
+    }
+
+    // Monitoring dates inside (0, T) must be piece starts
+    const std::vector<double> dates = option.monitoringDates();
+    for (double d : dates) {
+        bool aligned = d <= 0.0 || d >= T;
+        for (int k = 1; k < grid.pieces() && !aligned; ++k) aligned = grid.start(k) == d;
+        if (!aligned) throw std::invalid_argument("Monitoring date is not a time level of the grid.");
+    }
+    auto monitor = [&](double t, double* V) {
+        if (!std::binary_search(dates.begin(), dates.end(), t)) return;
+        for (int i = 0; i <= Ns; ++i) V[i] = option.knockOut(S[i], V[i]);
+    };
+
+    const bool american = option.isAmerican();
+    const int side = american ? option.exerciseSide() : 0;
+    const bool tracked = side != 0 && tileDepth_ <= 1;
+
+    ws.prepare(Ns + 1, maxSteps);
+
+    // Terminal condition and obstacle
+    double* V = ws.V.data();
+    for (int i = 0; i <= Ns; ++i) V[i] = option.payoff(S[i]);
+    monitor(T, V);
+    if (american) {
+        for (int i = 0; i <= Ns; ++i) ws.obstacle[i] = option.earlyExerciseValue(S[i]);
+    }
+
+    std::vector<double> boundary(tracked && keepV0 ? grid.Nt() : 0);
+    const double RT = model.rateIntegral(T);
+    const double QT = model.dividendIntegral(T);
+    int offset = grid.Nt();
+
+    // Pieces from maturity back to t = 0, one constant segment each
+    for (int k = grid.pieces() - 1; k >= 0; --k) {
+        const FdGrid& piece = grid.piece(k);
+        const double t0 = grid.start(k);
+        const TermStructureModel::Segment& seg = model.segment(model.segmentIndex(t0 + 0.5 * piece.T()));
+
+        coefficients(BlackScholesModel(seg.r, seg.sigma, seg.q), piece, ws.A.data(), ws.B.data(), ws.C.data());
+
+        // Boundary values under the mean r, q over [t, T] (the segment
+        // rate integrates linearly inside the piece)
+        const double R0 = model.rateIntegral(t0);
+        const double Q0 = model.dividendIntegral(t0);
+        for (int n = 0; n < piece.Nt(); ++n) {
+            const double t = t0 + piece.time(n);
+            if (boundaryModel) {
+                const double tau = T - t;
+                const double u = t - t0;
+                *boundaryModel = BlackScholesModel((RT - (R0 + seg.r * u)) / tau, seg.sigma,
+                                                   (QT - (Q0 + seg.q * u)) / tau);
+            }
+            ws.left[n]  = option.leftBoundary(t);
+            ws.right[n] = option.rightBoundary(t, Smax);
+        }
+
+        const double* Vk = american ? rollback<true>(piece, ws, nullptr, side) : rollback<false>(piece, ws);
+
+        offset -= piece.Nt();
+        if (!boundary.empty())
+            std::copy(ws.boundary.data(), ws.boundary.data() + piece.Nt(), boundary.begin() + offset);
+        if (Vk != V) std::copy(Vk, Vk + Ns + 1, V);
+        monitor(t0, V);
+    }
+
+    ws.setValues(V, Ns + 1);
+    Result res = makeResult(grid.piece(0), V, S0, keepV0);
+    res.exerciseBoundary = std::move(boundary);
+    return res;
+}
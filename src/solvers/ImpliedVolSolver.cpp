@@ -0,0 +1,208 @@
+#include "ImpliedVolSolver.hpp"
+#include "AnalyticBsPricer.hpp"
+#include "SolverWorkspace.hpp"
+#include "../grid/GridParameters.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include "../products/AmericanCall.hpp"
+#include "../products/AmericanPut.hpp"
+#include "../products/EuropeanCall.hpp"
+#include "../products/EuropeanPut.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// Black–Scholes–Merton price and vega of a call/put
+inline void bsPriceVega(bool call, double S0, double K, double T, double r, double q,
+                        double vol, double& price, double& vega)
+{
+    const double sqrtT = std::sqrt(T);
+    const double sd = vol * sqrtT;
+    const double d1 = (std::log(S0 / K) + (r - q) * T) / sd + 0.5 * sd;
+    const double d2 = d1 - sd;
+    const double dfq = std::exp(-q * T);
+    const double dfr = std::exp(-r * T);
+
+    price = call ? S0 * dfq * normal::cdf(d1) - K * dfr * normal::cdf(d2)
+                 : K * dfr * normal::cdf(-d2) - S0 * dfq * normal::cdf(-d1);
+    vega = S0 * dfq * normal::pdf(d1) * sqrtT;
+}
+
+// Vanilla call/put recognized for the closed-form warm start
+inline bool vanilla(const InterfaceProducts& product, bool& call)
+{
+    if (dynamic_cast<const AmericanPut*>(&product) || dynamic_cast<const EuropeanPut*>(&product)) {
+        call = false;
+        return true;
+    }
+    if (dynamic_cast<const AmericanCall*>(&product) || dynamic_cast<const EuropeanCall*>(&product)) {
+        call = true;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+ImpliedVolSolver::ImpliedVolSolver(const Config& config)
+    : config_(config)
+{
+    if (config_.rel_dS <= 0.0) throw std::invalid_argument("rel_dS must be > 0.");
+    if (config_.minVol <= 0.0 || config_.maxVol <= config_.minVol)
+        throw std::invalid_argument("Implied vol range must satisfy 0 < minVol < maxVol.");
+    if (config_.maxIterations < 2) throw std::invalid_argument("maxIterations must be >= 2.");
+}
+
+double ImpliedVolSolver::europeanImpliedVol(bool call, double price, double S0, double K, double T,
+                                            double r, double q)
+{
+    double lo = 1e-4, hi = 5.0;
+    double pLo, pHi, vega;
+    bsPriceVega(call, S0, K, T, r, q, lo, pLo, vega);
+    bsPriceVega(call, S0, K, T, r, q, hi, pHi, vega);
+    if (!(price > pLo && price < pHi)) return std::numeric_limits<double>::quiet_NaN();
+
+    double vol = 0.2;
+    for (int it = 0; it < 100; ++it) {
+        double p;
+        bsPriceVega(call, S0, K, T, r, q, vol, p, vega);
+        const double f = p - price;
+        if (std::fabs(f) < 1e-12 * std::max(1.0, price)) break;
+        if (f > 0.0) hi = vol; else lo = vol;
+
+        double next = vol - f / vega;
+        if (!(next > lo && next < hi)) next = 0.5 * (lo + hi);
+        if (std::fabs(next - vol) < 1e-14) { vol = next; break; }
+        vol = next;
+    }
+    return vol;
+}
+
+ImpliedVolSolver::Implied ImpliedVolSolver::solve(const Quote& quote,
+                                                 const BlackScholesModel& market,
+                                                 double S0,
+                                                 SolverWorkspace& ws) const
+{
+    if (!quote.product) throw std::invalid_argument("Null product in implied-vol quote.");
+    const InterfaceProducts& product = *quote.product;
+
+    const double r = market.r();
+    const double q = market.q();
+
+    Implied out;
+
+    // 1) Warm start: European closed-form vol of the quote
+    double vol0 = 0.3;
+    bool call = false;
+    const bool isVanilla = vanilla(product, call);
+    if (isVanilla) {
+        const double v = europeanImpliedVol(call, quote.price, S0, product.strike(), product.maturity(), r, q);
+        if (std::isfinite(v)) vol0 = v;
+    }
+    vol0 = std::min(std::max(vol0, config_.minVol), config_.maxVol);
+    out.warmStart = vol0;
+
+    // European vega at the warm start: slope for the first step
+    double vega0 = 0.0;
+    if (isVanilla) {
+        double p0;
+        bsPriceVega(call, S0, product.strike(), product.maturity(), r, q, vol0, p0, vega0);
+    }
+
+    // 2) One grid for all iterations, sized for a vol above the warm start
+    const BlackScholesModel gridModel(r, std::max(1.25 * vol0, 0.05), q);
+    const FdGrid grid = GridParameters::makeClusteredImplicitGrid(product, gridModel, S0, config_.rel_dS);
+
+    auto objective = [&](double vol) {
+        ++out.iterations;
+        return solver_.price(product, BlackScholesModel(r, vol, q), grid, S0, ws, false).price - quote.price;
+    };
+
+    // 3) Safeguarded secant; the price increases with vol, so every
+    //    evaluation tightens a bracket [lo, hi]
+    double lo = config_.minVol, hi = config_.maxVol;
+    bool haveLo = false, haveHi = false;
+    auto tighten = [&](double vol, double f) {
+        if (f < 0.0) { lo = vol; haveLo = true; }
+        else         { hi = vol; haveHi = true; }
+    };
+
+    double xa = vol0, fa = objective(xa);
+    tighten(xa, fa);
+    if (std::fabs(fa) <= config_.priceTol) {
+        out.vol = xa;
+        out.modelPrice = fa + quote.price;
+        out.converged = true;
+        return out;
+    }
+
+    // Second point: Newton step with the European vega (the first PDE solve
+    // measures the early-exercise premium), else a 3% move
+    double xb = vol0 * (fa > 0.0 ? 0.97 : 1.03);
+    if (vega0 > 1e-8 * S0) {
+        const double newton = vol0 - fa / vega0;
+        if (newton > 0.5 * vol0 && newton < 2.0 * vol0) xb = newton;
+    }
+    xb = std::min(std::max(xb, config_.minVol), config_.maxVol);
+    double fb = objective(xb);
+    tighten(xb, fb);
+
+    while (out.iterations < config_.maxIterations) {
+        if (std::fabs(fb) <= config_.priceTol) {
+            out.converged = true;
+            break;
+        }
+
+        double next = (fb != fa) ? xb - fb * (xb - xa) / (fb - fa) : 0.5 * (lo + hi);
+        if (!(next > lo && next < hi)) {
+            if (haveLo && haveHi) next = 0.5 * (lo + hi);
+            else if (!haveHi)     next = std::min(2.0 * std::max(xa, xb), config_.maxVol);
+            else                  next = std::max(0.5 * std::min(xa, xb), config_.minVol);
+        }
+
+        const double step = next - xb;
+        xa = xb; fa = fb;
+        xb = next;
+        fb = objective(xb);
+        tighten(xb, fb);
+
+        if (std::fabs(step) <= config_.volTol) {
+            out.converged = true;
+            break;
+        }
+        if (hi - lo <= config_.volTol && haveLo && haveHi) {
+            out.converged = true;
+            break;
+        }
+    }
+
+    if (out.converged) {
+        out.vol = xb;
+        out.modelPrice = fb + quote.price;
+    }
+    return out;
+}
+
+std::vector<ImpliedVolSolver::Implied>
+ImpliedVolSolver::solveChain(const std::vector<Quote>& chain,
+                             const BlackScholesModel& market,
+                             double S0,
+                             ThreadPool* pool) const
+{
+    const int N = static_cast<int>(chain.size());
+    std::vector<Implied> out(N);
+
+    if (!pool || pool->size() == 1 || N < 2) {
+        SolverWorkspace& ws = SolverWorkspace::threadLocal();
+        for (int k = 0; k < N; ++k) out[k] = solve(chain[k], market, S0, ws);
+        return out;
+    }
+
+    std::vector<SolverWorkspace> ws(pool->size());
+    pool->parallelFor(N, [&](int k, int participant) {
+        out[k] = solve(chain[k], market, S0, ws[participant]);
+    });
+    return out;
+}
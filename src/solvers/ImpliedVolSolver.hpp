@@ -0,0 +1,73 @@
+#pragma once
+#include <limits>
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "ThetaFdSolver.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+class ThreadPool;
+class SolverWorkspace;
+
+/**
+ * Implied volatility of (American) option quotes by PDE inversion
+ *
+ * Each quote is warm-started from the closed-form European implied vol of
+ * its price (vanilla calls and puts; the early-exercise premium puts the
+ * American vol just below it), then refined by safeguarded secant steps
+ * on Crank–Nicolson prices. The grid is built once per quote and every
+ * iteration reuses it with the same workspace, so an iteration costs one
+ * rollback and no allocation. Chains are split across a ThreadPool, one
+ * workspace per participant.
+ */
+class ImpliedVolSolver {
+public:
+    struct Config {
+        double rel_dS = 0.005;     // resolution of the PDE grid (clustered, CN)
+        double volTol = 1e-6;      // stop when the vol step is below volTol
+        double priceTol = 1e-8;    // or when |model - quote| is below priceTol
+        int maxIterations = 30;
+        double minVol = 1e-3;
+        double maxVol = 5.0;
+    };
+
+    struct Quote {
+        const InterfaceProducts* product;
+        double price;
+    };
+
+    struct Implied {
+        double vol = std::numeric_limits<double>::quiet_NaN();
+        double modelPrice = 0.0;   // PDE price at vol
+        double warmStart = 0.0;    // initial guess
+        int iterations = 0;        // PDE solves
+        bool converged = false;
+    };
+
+    ImpliedVolSolver() = default;
+    explicit ImpliedVolSolver(const Config& config);
+
+    const Config& config() const { return config_; }
+
+    // market: rate and dividend yield (its sigma is not used)
+    Implied solve(const Quote& quote,
+                  const BlackScholesModel& market,
+                  double S0,
+                  SolverWorkspace& ws) const;
+
+    // Whole chain, quotes handed out dynamically across the pool (serial if
+    // pool is null); results in input order
+    std::vector<Implied> solveChain(const std::vector<Quote>& chain,
+                                    const BlackScholesModel& market,
+                                    double S0,
+                                    ThreadPool* pool = nullptr) const;
+
+    // Closed-form Black–Scholes–Merton implied vol of a European call/put
+    // (Newton with bisection fallback); NaN if the price has no solution
+    static double europeanImpliedVol(bool call, double price, double S0, double K, double T,
+                                     double r, double q);
+
+private:
+    Config config_;
+    ThetaFdSolver solver_;
+};
@@ -0,0 +1,107 @@
+#include "LogFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+LogFdSolver::LogFdSolver()
+    : kernels_(&stencil::bestKernels())
+{
+}
+
+LogFdSolver::LogFdSolver(stencil::SimdLevel level)
+    : kernels_(&stencil::kernels(level))
+{
+}
+
+LogFdSolver::Result LogFdSolver::price(const InterfaceProducts& option,
+                                      const BlackScholesModel& model,
+                                      const FdGrid& grid,
+                                      double S0) const
+{
+    return price(option, model, grid, S0, SolverWorkspace::threadLocal());
+}
+
+LogFdSolver::Result LogFdSolver::price(const InterfaceProducts& option,
+                                      const BlackScholesModel& model,
+                                      const FdGrid& grid,
+                                      double S0,
+                                      SolverWorkspace& ws,
+                                      bool keepV0) const
+{
+    validateGrid(grid);
+    ExplicitFdSolver::validateBarrier(option, grid);
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const auto& S = grid.priceGrid();
+    const bool american = option.isAmerican();
+
+    const Coefficients k = coefficients(model, grid);
+
+    ws.prepare(Ns + 1, Nt);
+
+    // Dirichlet values at Smax (and at a lower knock-out barrier), evaluated
+    // once before the rollback
+    const bool lowerBarrier = option.continuousBarrier() && option.lowerBarrier() > 0.0;
+    double* left = ws.left.data();
+    double* right = ws.right.data();
+    for (int n = 0; n < Nt; ++n) {
+        right[n] = option.rightBoundary(grid.time(n), S.back());
+        if (lowerBarrier) left[n] = option.leftBoundary(grid.time(n));
+    }
+
+    // Terminal condition and time-independent obstacle
+    double* V = ws.V.data();
+    double* Vnew = ws.Vnew.data();
+    double* exercise = ws.obstacle.data();
+    for (int i = 0; i <= Ns; ++i) {
+        V[i] = option.payoff(S[i]);
+        if (american) exercise[i] = option.earlyExerciseValue(S[i]);
+    }
+
+    // Zero gamma at Smin: V[0] = V[1] + w (V[1] - V[2])
+    const double w = (S[1] - S[0]) / (S[2] - S[1]);
+
+    for (int n = Nt - 1; n >= 0; --n) {
+        if (american) {
+            kernels_->stepConstAmerican(k.a, k.b, k.c, V, exercise, Vnew, 1, Ns);
+        } else {
+            kernels_->stepConst(k.a, k.b, k.c, V, Vnew, 1, Ns);
+        }
+
+        Vnew[Ns] = right[n];
+        Vnew[0]  = lowerBarrier ? left[n] : Vnew[1] + w * (Vnew[1] - Vnew[2]);
+        if (american) Vnew[0] = std::max(Vnew[0], exercise[0]);
+
+        std::swap(V, Vnew);
+    }
+
+    ws.setValues(V, Ns + 1);
+    return ExplicitFdSolver::makeResult(grid, V, S0, keepV0);
+}
+
+LogFdSolver::Coefficients LogFdSolver::coefficients(const BlackScholesModel& model,
+                                                    const FdGrid& grid)
+{
+    const double dx = grid.dx();
+    const double dt = grid.dt();
+
+    const double r = model.r();
+    const double sigma2 = model.sigma() * model.sigma();
+    const double nu = model.r() - model.q() - 0.5 * sigma2;
+
+    Coefficients k;
+    k.a = 0.5 * dt * ( sigma2 / (dx * dx) - nu / dx );
+    k.b = 1.0 - dt * ( sigma2 / (dx * dx) + r );
+    k.c = 0.5 * dt * ( sigma2 / (dx * dx) + nu / dx );
+    return k;
+}
+
+void LogFdSolver::validateGrid(const FdGrid& grid)
+{
+    ExplicitFdSolver::validateGrid(grid);
+
+    if (!grid.logUniform())
+        throw std::invalid_argument("LogFdSolver needs a log-uniform grid (FdGrid::logUniform).");
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "ExplicitFdSolver.hpp"
+#include "StencilKernels.hpp"
+#include "../grid/FdGrid.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+class SolverWorkspace;
+
+/**
+ * Explicit finite-difference solver in log-price x = ln S
+ *
+ * On a log-uniform grid (FdGrid::logUniform, GridParameters::makeLogGrid)
+ *   V_t + 0.5 sigma^2 V_xx + (r - q - 0.5 sigma^2) V_x - r V = 0
+ * has constant coefficients: the stencil is three scalars for the whole
+ * solve, and the stability limit dt <= dx^2 / sigma^2 does not depend on
+ * Smax. Products are unchanged (payoff and obstacle taken at S_i = e^{x_i}).
+ * Boundaries: the product's rightBoundary at Smax; at Smin > 0 the value is
+ * extrapolated linearly in S (zero gamma), leftBoundary() being the S = 0 value,
+ * unless Smin is a continuously monitored knock-out barrier (leftBoundary there).
+ */
+class LogFdSolver {
+public:
+    using Result = ExplicitFdSolver::Result;
+
+    // V_new[i] = a V[i-1] + b V[i] + c V[i+1] on every interior node
+    struct Coefficients {
+        double a, b, c;
+    };
+
+    // Uses the best SIMD stencil kernel of the host
+    LogFdSolver();
+
+    // Forces a SIMD level (capped to what the host supports)
+    explicit LogFdSolver(stencil::SimdLevel level);
+
+    stencil::SimdLevel simdLevel() const { return kernels_->level; }
+
+    // Buffers come from the calling thread's SolverWorkspace
+    Result price(const InterfaceProducts& option,
+                 const BlackScholesModel& model,
+                 const FdGrid& grid,
+                 double S0) const;
+
+    // Same with an explicit workspace (see ExplicitFdSolver::price)
+    Result price(const InterfaceProducts& option,
+                 const BlackScholesModel& model,
+                 const FdGrid& grid,
+                 double S0,
+                 SolverWorkspace& ws,
+                 bool keepV0 = true) const;
+
+    static Coefficients coefficients(const BlackScholesModel& model, const FdGrid& grid);
+
+    // Throws unless the grid is log-uniform
+    static void validateGrid(const FdGrid& grid);
+
+private:
+    const stencil::Kernels* kernels_;
+};
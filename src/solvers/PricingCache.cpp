@@ -0,0 +1,179 @@
+#include "PricingCache.hpp"
+#include "../products/BarrierOption.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+
+namespace {
+
+inline void mix(std::size_t& h, std::uint64_t x)
+{
+    // 64-bit FNV-1a style combination of whole words
+    h ^= static_cast<std::size_t>(x);
+    h *= static_cast<std::size_t>(1099511628211ULL);
+}
+
+inline std::uint64_t bits(double x)
+{
+    std::uint64_t b;
+    std::memcpy(&b, &x, sizeof(b));
+    return b;
+}
+
+// Bitwise equality of doubles (a key is an exact description)
+inline bool same(const std::vector<double>& a, const std::vector<double>& b)
+{
+    return a.size() == b.size()
+        && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+// strikes(), followed for knock-outs by their type, barrier, rebate and
+// monitoring dates
+std::vector<double> productTerms(const InterfaceProducts& option)
+{
+    std::vector<double> terms = option.strikes();
+    if (auto* b = dynamic_cast<const BarrierOption*>(&option)) {
+        terms.insert(terms.end(), {static_cast<double>(b->type()), b->barrier(), b->rebate()});
+        const std::vector<double> dates = b->monitoringDates();
+        terms.insert(terms.end(), dates.begin(), dates.end());
+    }
+    return terms;
+}
+
+} // namespace
+
+bool PricingCache::Key::operator==(const Key& o) const
+{
+    return hash == o.hash && type == o.type && american == o.american
+        && bits(maturity) == bits(o.maturity) && bits(r) == bits(o.r)
+        && bits(sigma) == bits(o.sigma) && bits(q) == bits(o.q)
+        && bits(T) == bits(o.T) && Nt == o.Nt && Ns == o.Ns && uniform == o.uniform
+        && same(strikes, o.strikes) && same(nodes, o.nodes);
+}
+
+PricingCache::PricingCache(const ExplicitFdSolver& solver, std::size_t maxBytes)
+    : solver_(solver), maxBytes_(maxBytes)
+{
+}
+
+PricingCache::Key PricingCache::makeKey(const InterfaceProducts& option,
+                                        const BlackScholesModel& model,
+                                        const FdGrid& grid)
+{
+    const auto& S = grid.priceGrid();
+    Key k{std::type_index(typeid(option)), option.isAmerican(),
+          option.maturity(), model.r(), model.sigma(), model.q(),
+          productTerms(option),
+          grid.T(), grid.Nt(), grid.Ns(), grid.uniform(),
+          grid.uniform() ? std::vector<double>{S.front(), S.back()} : S,
+          0};
+
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ULL);
+    mix(h, k.type.hash_code());
+    mix(h, k.american);
+    for (double x : {k.maturity, k.r, k.sigma, k.q, k.T}) mix(h, bits(x));
+    mix(h, static_cast<std::uint64_t>(k.Nt));
+    mix(h, static_cast<std::uint64_t>(k.Ns));
+    for (double x : k.strikes) mix(h, bits(x));
+    for (double x : k.nodes) mix(h, bits(x));
+    k.hash = h;
+    return k;
+}
+
+std::size_t PricingCache::entryBytes(const FdGrid& grid)
+{
+    // V0 + key nodes + node/list bookkeeping
+    const std::size_t nodes = grid.uniform() ? 2 : grid.Ns() + 1;
+    return sizeof(double) * (grid.Ns() + 1 + nodes) + sizeof(Key) + sizeof(Entry) + 64;
+}
+
+ExplicitFdSolver::Result PricingCache::price(const InterfaceProducts& option,
+                                             const BlackScholesModel& model,
+                                             const FdGrid& grid,
+                                             double S0,
+                                             bool keepV0)
+{
+    Key key = makeKey(option, model, grid);
+    const std::size_t bytes = entryBytes(grid);
+
+    std::shared_future<Values> values;
+    std::promise<Values> promise;
+    bool solve = false;
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            ++counters_.hits;
+            lru_.splice(lru_.begin(), lru_, it->second.lru);
+            values = it->second.values;
+        } else {
+            ++counters_.misses;
+            solve = true;
+            id = ++nextId_;
+            values = promise.get_future().share();
+            if (bytes <= maxBytes_) {
+                evictFor(bytes);
+                auto ins = map_.emplace(std::move(key), Entry{values, {}, bytes, id}).first;
+                lru_.push_front(&ins->first);
+                ins->second.lru = lru_.begin();
+                counters_.bytes += bytes;
+                ++counters_.entries;
+            }
+        }
+    }
+
+    if (solve) {
+        try {
+            auto res = solver_.price(option, model, grid, S0);
+            auto stored = std::make_shared<const std::vector<double>>(std::move(res.V0));
+            promise.set_value(stored);
+            if (keepV0) res.V0 = *stored;
+            return res;
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+            // Drop the failed entry (if still ours) so the next call retries
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = map_.find(makeKey(option, model, grid));
+            if (it != map_.end() && it->second.id == id) {
+                counters_.bytes -= it->second.bytes;
+                --counters_.entries;
+                lru_.erase(it->second.lru);
+                map_.erase(it);
+            }
+            throw;
+        }
+    }
+
+    const Values V0 = values.get();   // waits for an in-flight solve
+    return ExplicitFdSolver::makeResult(grid, V0->data(), S0, keepV0);
+}
+
+void PricingCache::evictFor(std::size_t bytes)
+{
+    while (!lru_.empty() && counters_.bytes + bytes > maxBytes_) {
+        const Key* victim = lru_.back();
+        auto it = map_.find(*victim);
+        counters_.bytes -= it->second.bytes;
+        --counters_.entries;
+        ++counters_.evictions;
+        lru_.pop_back();
+        map_.erase(it);
+    }
+}
+
+PricingCache::Counters PricingCache::counters() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return counters_;
+}
+
+void PricingCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_.clear();
+    lru_.clear();
+    counters_.entries = 0;
+    counters_.bytes = 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "../grid/FdGrid.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+/**
+ * Thread-safe LRU cache of explicit-solver rollbacks
+ *
+ * An entry holds the t=0 values V0 of one (product, model, grid) solve,
+ * keyed on the product's dynamic type, strikes(), maturity() and exercise
+ * style, the model's (r, sigma, q) and the grid geometry (Nt, T, nodes),
+ * all compared exactly. The spot is not part of the key: a hit at a new S0
+ * is interpolated on the stored V0 with the solver's own makeResult, so it
+ * returns exactly what a fresh solve would.
+ *
+ * Concurrent misses on the same key share one solve: the first caller
+ * rolls back, the others wait for its result. Memory is bounded by
+ * maxBytes (V0 plus bookkeeping per entry); least recently used entries
+ * are evicted first.
+ *
+ * Products must be fully described by their type, strikes and maturity
+ * (BarrierOption: plus its barrier terms), and priced with the model they
+ * were built with (as everywhere in this library).
+ */
+class PricingCache {
+public:
+    struct Counters {
+        std::uint64_t hits = 0;       // served from a stored (or in-flight) solve
+        std::uint64_t misses = 0;     // solved
+        std::uint64_t evictions = 0;
+        std::size_t entries = 0;
+        std::size_t bytes = 0;
+    };
+
+    // solver must outlive the cache
+    explicit PricingCache(const ExplicitFdSolver& solver, std::size_t maxBytes = std::size_t(64) << 20);
+
+    PricingCache(const PricingCache&) = delete;
+    PricingCache& operator=(const PricingCache&) = delete;
+
+    // Cached equivalent of solver.price(option, model, grid, S0); with
+    // keepV0 = false Result::V0 is left empty
+    ExplicitFdSolver::Result price(const InterfaceProducts& option,
+                                   const BlackScholesModel& model,
+                                   const FdGrid& grid,
+                                   double S0,
+                                   bool keepV0 = true);
+
+    Counters counters() const;
+    std::size_t maxBytes() const { return maxBytes_; }
+    void clear();
+
+private:
+    struct Key {
+        std::type_index type;
+        bool american;
+        double maturity, r, sigma, q;
+        std::vector<double> strikes;  // then barrier terms, if any
+        double T;
+        int Nt, Ns;
+        bool uniform;
+        std::vector<double> nodes;    // all nodes if non-uniform, else {Smin, Smax}
+        std::size_t hash;
+
+        bool operator==(const Key& o) const;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& k) const { return k.hash; }
+    };
+
+    using Values = std::shared_ptr<const std::vector<double>>;
+
+    struct Entry {
+        std::shared_future<Values> values;
+        std::list<const Key*>::iterator lru;
+        std::size_t bytes;
+        std::uint64_t id;             // tells a retried key from the failed one
+    };
+
+    static Key makeKey(const InterfaceProducts& option, const BlackScholesModel& model, const FdGrid& grid);
+    static std::size_t entryBytes(const FdGrid& grid);
+
+    void evictFor(std::size_t bytes);   // caller holds mutex_
+
+    const ExplicitFdSolver& solver_;
+    std::size_t maxBytes_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<Key, Entry, KeyHash> map_;
+    std::list<const Key*> lru_;         // most recent first; points at map keys
+    Counters counters_;
+    std::uint64_t nextId_ = 0;
+};
@@ -0,0 +1,106 @@
+#include "PricingEngine.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "../grid/GridParameters.hpp"
+
+PricingEngine::Priced PricingEngine::price(const InterfaceProducts& product,
+                                          const BlackScholesModel& model,
+                                          double S0) const
+{
+    Priced out;
+    if (!config_.forcePde && AnalyticBsPricer::supports(product)) {
+        out.result = analytic_.price(product, model, S0);
+        out.method = Method::Analytic;
+        return out;
+    }
+
+    FdGrid grid = GridParameters::makeGrid(product, model, S0, config_.rel_dS);
+    out.result = pde_.price(product, model, grid, S0);
+    out.method = Method::Pde;
+    out.Nt = grid.Nt();
+    out.Ns = grid.Ns();
+    return out;
+}
+
+std::vector<PricingEngine::Priced>
+PricingEngine::priceBatch(const std::vector<const InterfaceProducts*>& products,
+                          const BlackScholesModel& model,
+                          double S0) const
+{
+    const int N = static_cast<int>(products.size());
+    std::vector<Priced> out(N);
+
+    std::vector<const InterfaceProducts*> closedForm;
+    std::vector<int> closedFormIdx;
+    std::vector<int> pdeIdx;
+
+    for (int k = 0; k < N; ++k) {
+        if (!products[k]) throw std::invalid_argument("Null product in batch.");
+        if (!config_.forcePde && AnalyticBsPricer::supports(*products[k])) {
+            closedForm.push_back(products[k]);
+            closedFormIdx.push_back(k);
+        } else {
+            pdeIdx.push_back(k);
+        }
+    }
+
+    // 1) Closed form: one vectorized pass over all legs
+    if (!closedForm.empty()) {
+        auto res = analytic_.priceBatch(closedForm, model, S0);
+        for (std::size_t j = 0; j < res.size(); ++j) {
+            out[closedFormIdx[j]].result = std::move(res[j]);
+            out[closedFormIdx[j]].method = Method::Analytic;
+        }
+    }
+
+    // 2) PDE: one shared-grid batch per maturity. Barrier products get
+    // their own grid (ended on, or aligned with, the barrier) and their
+    // own solve, which also handles monitoring dates
+    auto ownGrid = [](const InterfaceProducts& p) {
+        return p.lowerBarrier() > 0.0 || std::isfinite(p.upperBarrier()) || !p.monitoringDates().empty();
+    };
+
+    std::vector<bool> done(pdeIdx.size(), false);
+    for (std::size_t a = 0; a < pdeIdx.size(); ++a) {
+        if (done[a]) continue;
+
+        const InterfaceProducts& lead = *products[pdeIdx[a]];
+        std::vector<const InterfaceProducts*> group;
+        std::vector<int> groupIdx;
+        for (std::size_t b = a; b < pdeIdx.size(); ++b) {
+            const InterfaceProducts* p = products[pdeIdx[b]];
+            if (b > a && (ownGrid(lead) || ownGrid(*p))) continue;
+            if (!done[b] && std::fabs(p->maturity() - lead.maturity()) <= 1e-12 * lead.maturity()) {
+                group.push_back(p);
+                groupIdx.push_back(pdeIdx[b]);
+                done[b] = true;
+            }
+        }
+
+        FdGrid grid = GridParameters::makeGrid(lead, model, S0, config_.rel_dS);
+        auto res = (group.size() == 1)
+            ? std::vector<ExplicitFdSolver::Result>{pde_.price(lead, model, grid, S0)}
+            : pde_.priceBatch(group, model, grid, S0);
+
+        for (std::size_t j = 0; j < res.size(); ++j) {
+            Priced& p = out[groupIdx[j]];
+            p.result = std::move(res[j]);
+            p.method = Method::Pde;
+            p.Nt = grid.Nt();
+            p.Ns = grid.Ns();
+        }
+    }
+
+    return out;
+}
+
+const char* PricingEngine::name(Method method)
+{
+    switch (method) {
+        case Method::Analytic: return "closed form";
+        case Method::Pde:      return "PDE (explicit)";
+    }
+    return "unknown";
+}
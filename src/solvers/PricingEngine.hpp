@@ -0,0 +1,53 @@
+#pragma once
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "AnalyticBsPricer.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+/**
+ * Routes each product to the cheapest exact engine:
+ * closed form (AnalyticBsPricer) when the product has one, explicit PDE on
+ * a GridParameters::makeGrid grid otherwise (American and user-defined
+ * products). forcePde keeps every product on the PDE path, for validation.
+ */
+class PricingEngine {
+public:
+    enum class Method { Analytic, Pde };
+
+    struct Config {
+        double rel_dS = 0.002;  // PDE spatial step as a fraction of S0
+        bool forcePde = false;  // skip the closed-form route
+    };
+
+    struct Priced {
+        ExplicitFdSolver::Result result;
+        Method method;
+        int Nt = 0;             // PDE grid size (0 for closed form)
+        int Ns = 0;
+    };
+
+    PricingEngine() = default;
+    explicit PricingEngine(const Config& config) : config_(config) {}
+
+    const Config& config() const { return config_; }
+
+    Priced price(const InterfaceProducts& product,
+                 const BlackScholesModel& model,
+                 double S0) const;
+
+    // Closed-form products are priced in one vectorized call; PDE products
+    // are grouped by maturity and rolled back together on a shared grid;
+    // barrier products are priced one by one on their own grids.
+    // Results are returned in input order.
+    std::vector<Priced> priceBatch(const std::vector<const InterfaceProducts*>& products,
+                                   const BlackScholesModel& model,
+                                   double S0) const;
+
+    static const char* name(Method method);
+
+private:
+    Config config_;
+    ExplicitFdSolver pde_;
+    AnalyticBsPricer analytic_;
+};
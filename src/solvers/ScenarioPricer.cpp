@@ -0,0 +1,324 @@
+#include "ScenarioPricer.hpp"
+#include "../grid/GridParameters.hpp"
+#include "../parallel/ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Node constants (a2, a1, c2, c1) of the lane kernels: the off-diagonal
+// coefficients of ExplicitFdSolver::coefficients split into their sigma^2
+// and (r - q) parts, A = sigma^2 a2 + (r - q) a1; the diagonal follows as
+// B = 1 - r dt - (A + C), the derivative weights summing to zero
+std::vector<double> nodeConstants(const FdGrid& grid)
+{
+    const int Ns = grid.Ns();
+    const double dS = grid.dS();
+    const double dt = grid.dt();
+    const auto& S = grid.priceGrid();
+
+    std::vector<double> g(4 * static_cast<std::size_t>(Ns + 1), 0.0);   // boundary nodes unused
+    for (int i = 1; i < Ns; ++i) {
+        double* gi = g.data() + 4 * i;
+        const double Si = S[i];
+
+        if (grid.uniform()) {
+            const double x2 = Si * Si / (dS * dS);
+            const double x1 = Si / dS;
+            gi[0] = 0.5 * dt * x2;
+            gi[1] = -0.5 * dt * x1;
+            gi[2] = 0.5 * dt * x2;
+            gi[3] = 0.5 * dt * x1;
+        } else {
+            const FdGrid::Weights d = grid.weights(i);
+            const double halfS2 = 0.5 * dt * Si * Si;
+            gi[0] = halfS2 * d.d2m;
+            gi[1] = dt * Si * d.d1m;
+            gi[2] = halfS2 * d.d2p;
+            gi[3] = dt * Si * d.d1p;
+        }
+    }
+    return g;
+}
+
+// One product per scenario; all must be non-null and share the exercise style
+std::vector<std::unique_ptr<InterfaceProducts>> buildProducts(const ProductBuilder& makeProduct,
+                                                              const std::vector<BlackScholesModel>& scenarios)
+{
+    std::vector<std::unique_ptr<InterfaceProducts>> products;
+    products.reserve(scenarios.size());
+    for (const BlackScholesModel& model : scenarios) {
+        products.push_back(makeProduct(model));
+        const InterfaceProducts* option = products.back().get();
+        if (!option) throw std::invalid_argument("Product builder returned null.");
+        if (option->isAmerican() != products.front()->isAmerican())
+            throw std::invalid_argument("All scenario products must share the exercise style.");
+    }
+    return products;
+}
+
+// Maturity and barriers of the scenarios index[0..L) against their grid
+void checkGrid(const std::vector<std::unique_ptr<InterfaceProducts>>& products,
+               const int* index, int L, const FdGrid& grid)
+{
+    for (int k = 0; k < L; ++k) {
+        const InterfaceProducts& option = *products[index[k]];
+        if (std::fabs(option.maturity() - grid.T()) > 1e-12 * grid.T())
+            throw std::invalid_argument("Scenario product maturity differs from the grid maturity.");
+        ExplicitFdSolver::validateBarrier(option, grid);
+    }
+}
+
+// Exercise obstacle shared by the scenarios index[0..L) (empty if
+// European): the exercise value must not depend on the scenario model
+std::vector<double> sharedObstacle(const std::vector<std::unique_ptr<InterfaceProducts>>& products,
+                                   const int* index, int L, const FdGrid& grid)
+{
+    std::vector<double> obstacle;
+    const InterfaceProducts& first = *products[index[0]];
+    if (!first.isAmerican()) return obstacle;
+
+    const int Ns = grid.Ns();
+    const auto& S = grid.priceGrid();
+    obstacle.resize(Ns + 1);
+    for (int i = 0; i <= Ns; ++i) obstacle[i] = first.earlyExerciseValue(S[i]);
+    for (int k = 1; k < L; ++k)
+        for (int i = 0; i <= Ns; ++i)
+            if (products[index[k]]->earlyExerciseValue(S[i]) != obstacle[i])
+                throw std::invalid_argument("Exercise value differs across scenarios.");
+    return obstacle;
+}
+
+// Rolls back the scenarios index[0..L) together and writes their
+// (price, delta, gamma) rows
+void rollbackPass(const stencil::Kernels& kernels,
+                  const std::vector<std::unique_ptr<InterfaceProducts>>& products,
+                  const std::vector<BlackScholesModel>& scenarios,
+                  const int* index, int L,
+                  const FdGrid& grid,
+                  const double* g,
+                  const double* obstacle,
+                  double S0,
+                  double* rows)
+{
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const auto& S = grid.priceGrid();
+    const std::size_t size = static_cast<std::size_t>(Ns + 1) * L;
+
+    // Lane constants and terminal values, node-major
+    std::vector<double> s(L), m(L), b0(L);
+    std::vector<double> V(size), Vnew(size);
+    for (int k = 0; k < L; ++k) {
+        const BlackScholesModel& model = scenarios[index[k]];
+        s[k]  = model.sigma() * model.sigma();
+        m[k]  = model.r() - model.q();
+        b0[k] = 1.0 - grid.dt() * model.r();
+
+        const InterfaceProducts& option = *products[index[k]];
+        for (int i = 0; i <= Ns; ++i) V[static_cast<std::size_t>(i) * L + k] = option.payoff(S[i]);
+    }
+
+    // Backward time stepping, all lanes per kernel call
+    double* v = V.data();
+    double* out = Vnew.data();
+    const double Smax = S.back();
+
+    for (int n = Nt - 1; n >= 0; --n) {
+        const double tn = grid.time(n);
+        double* outLast = out + static_cast<std::size_t>(Ns) * L;
+        for (int k = 0; k < L; ++k) {
+            out[k]     = products[index[k]]->leftBoundary(tn);
+            outLast[k] = products[index[k]]->rightBoundary(tn, Smax);
+        }
+
+        if (obstacle)
+            kernels.stepLanesAmerican(g, s.data(), m.data(), b0.data(), v, obstacle, out, L, 1, Ns);
+        else
+            kernels.stepLanes(g, s.data(), m.data(), b0.data(), v, out, L, 1, Ns);
+
+        std::swap(v, out);
+    }
+
+    // Gather each lane's V(0) and read price and Greeks as the solver does
+    std::vector<double> V0(Ns + 1);
+    for (int k = 0; k < L; ++k) {
+        for (int i = 0; i <= Ns; ++i) V0[i] = v[static_cast<std::size_t>(i) * L + k];
+
+        const ExplicitFdSolver::Result res = ExplicitFdSolver::makeResult(grid, V0.data(), S0, false);
+        double* row = rows + static_cast<std::size_t>(ScenarioPricer::Result::kColumns) * index[k];
+        row[0] = res.price;
+        row[1] = res.delta;
+        row[2] = res.gamma;
+    }
+}
+
+} // namespace
+
+ScenarioPricer::ScenarioPricer(const Config& config, ThreadPool* pool)
+    : config_(config), pool_(pool)
+{
+    if (config_.lanesPerPass < 1) throw std::invalid_argument("lanesPerPass must be >= 1.");
+}
+
+ScenarioPricer::ScenarioPricer(const Config& config, ThreadPool* pool, stencil::SimdLevel level)
+    : ScenarioPricer(config, pool)
+{
+    kernels_ = &stencil::kernels(level);
+}
+
+void ScenarioPricer::runPasses(int passes, const std::function<void(int)>& pass) const
+{
+    if (pool_ && pool_->size() > 1 && passes > 1) {
+        pool_->parallelFor(passes, [&](int p, int /*participant*/) { pass(p); });
+    } else {
+        for (int p = 0; p < passes; ++p) pass(p);
+    }
+}
+
+ScenarioPricer::Result ScenarioPricer::price(const ProductBuilder& makeProduct,
+                                             const std::vector<BlackScholesModel>& scenarios,
+                                             const FdGrid& grid,
+                                             double S0) const
+{
+    ExplicitFdSolver::validateGrid(grid);
+
+    const int M = static_cast<int>(scenarios.size());
+
+    Result result;
+    result.scenarios = M;
+    result.values.assign(static_cast<std::size_t>(Result::kColumns) * M, 0.0);
+    if (M == 0) return result;
+
+    const auto products = buildProducts(makeProduct, scenarios);
+    std::vector<int> index(M);
+    for (int k = 0; k < M; ++k) index[k] = k;
+    checkGrid(products, index.data(), M, grid);
+
+    const std::vector<double> obstacle = sharedObstacle(products, index.data(), M, grid);
+    const std::vector<double> g = nodeConstants(grid);
+    const int lanes = std::min(config_.lanesPerPass, M);
+    const int passes = (M + lanes - 1) / lanes;
+
+    runPasses(passes, [&](int p) {
+        const int k0 = p * lanes;
+        rollbackPass(*kernels_, products, scenarios, index.data() + k0, std::min(lanes, M - k0), grid, g.data(),
+                     obstacle.empty() ? nullptr : obstacle.data(), S0, result.values.data());
+    });
+    return result;
+}
+
+ScenarioPricer::Result ScenarioPricer::price(const ProductBuilder& makeProduct,
+                                             const std::vector<BlackScholesModel>& scenarios,
+                                             double S0,
+                                             double rel_dS) const
+{
+    if (rel_dS <= 0.0) throw std::invalid_argument("rel_dS must be > 0.");
+
+    const int M = static_cast<int>(scenarios.size());
+
+    Result result;
+    result.scenarios = M;
+    result.values.assign(static_cast<std::size_t>(Result::kColumns) * M, 0.0);
+    if (M == 0) return result;
+
+    const auto products = buildProducts(makeProduct, scenarios);
+
+    // Buckets: scenarios ordered by the cost of their own explicit grid
+    // (time steps, then nodes), so that each pass groups scenarios of
+    // similar stability limit and domain
+    std::vector<std::pair<double, double>> cost(M);
+    for (int k = 0; k < M; ++k) {
+        const FdGrid own = GridParameters::makeGrid(*products[k], scenarios[k], S0, rel_dS);
+        cost[k] = {static_cast<double>(own.Nt()), static_cast<double>(own.Ns())};
+    }
+    std::vector<int> order(M);
+    for (int k = 0; k < M; ++k) order[k] = k;
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return cost[a] < cost[b]; });
+
+    const int lanes = std::min(config_.lanesPerPass, M);
+    const int passes = (M + lanes - 1) / lanes;
+
+    runPasses(passes, [&](int p) {
+        const int k0 = p * lanes;
+        const int L = std::min(lanes, M - k0);
+        const int* index = order.data() + k0;
+
+        std::vector<BlackScholesModel> models;
+        models.reserve(L);
+        for (int k = 0; k < L; ++k) models.push_back(scenarios[index[k]]);
+        const FdGrid grid = makeGrid(*products[index[0]], models, S0, rel_dS);
+        checkGrid(products, index, L, grid);
+
+        const std::vector<double> obstacle = sharedObstacle(products, index, L, grid);
+        const std::vector<double> g = nodeConstants(grid);
+        rollbackPass(*kernels_, products, scenarios, index, L, grid, g.data(),
+                     obstacle.empty() ? nullptr : obstacle.data(), S0, result.values.data());
+    });
+    return result;
+}
+
+ScenarioPricer::Result ScenarioPricer::price(ProductType type, double K1, double K2, double T,
+                                             const std::vector<BlackScholesModel>& scenarios,
+                                             const FdGrid& grid,
+                                             double S0) const
+{
+    return price(ProductFactory::builder(type, K1, K2, T), scenarios, grid, S0);
+}
+
+ScenarioPricer::Result ScenarioPricer::price(ProductType type, double K1, double K2, double T,
+                                             const std::vector<BlackScholesModel>& scenarios,
+                                             double S0,
+                                             double rel_dS) const
+{
+    return price(ProductFactory::builder(type, K1, K2, T), scenarios, S0, rel_dS);
+}
+
+FdGrid ScenarioPricer::makeGrid(const InterfaceProducts& product,
+                                const std::vector<BlackScholesModel>& scenarios,
+                                double S0,
+                                double rel_dS)
+{
+    if (scenarios.empty()) throw std::invalid_argument("Scenario grid needs at least one scenario.");
+    if (rel_dS <= 0.0) throw std::invalid_argument("rel_dS must be > 0.");
+
+    // Widest S-domain of the scenario grids (the continuously monitored
+    // barriers, if any, end every one of them)
+    GridParameters::UniformDomain d{};
+    for (const BlackScholesModel& model : scenarios) {
+        const GridParameters::UniformDomain own = GridParameters::uniformDomain(product, model, S0, rel_dS * S0, 0.0);
+        if (own.Smax > d.Smax) d = own;
+    }
+    const double Smax = d.Smax;
+    const double dS = d.dS;
+
+    // Explicit stability of the most demanding scenario (worst case at Smax)
+    double denom = 0.0;
+    for (const BlackScholesModel& model : scenarios) {
+        const double sig = model.sigma();
+        denom = std::max(denom, (sig * sig * Smax * Smax) / (dS * dS) + model.r());
+    }
+
+    const double dt = 0.45 / denom;
+    const int Nt = static_cast<int>(std::ceil(product.maturity() / dt));
+
+    return FdGrid(product.maturity(), Smax, Nt, d.Ns, d.Smin);
+}
+
+std::vector<BlackScholesModel> ScenarioPricer::shocked(const BlackScholesModel& base,
+                                                       const std::vector<double>& volShifts,
+                                                       const std::vector<double>& rateShifts,
+                                                       const std::vector<double>& dividendShifts)
+{
+    std::vector<BlackScholesModel> scenarios;
+    scenarios.reserve(volShifts.size() * rateShifts.size() * dividendShifts.size());
+
+    for (double dv : volShifts)
+        for (double dr : rateShifts)
+            for (double dq : dividendShifts)
+                scenarios.emplace_back(base.r() + dr, base.sigma() + dv, base.q() + dq);
+    return scenarios;
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "../grid/FdGrid.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+#include "../products/ProductFactory.hpp"
+
+class ThreadPool;
+
+/**
+ * Stress-scenario pricing: one product rolled back under many models
+ * (sigma, r, q) on explicit grids shared by passes of scenarios
+ *
+ * Scenarios are advanced together, a pass of lanes at a time: values are
+ * stored node-major (lane k of node i at i*lanes + k), so one sweep of the
+ * lane kernel over the grid updates every scenario of the pass in SIMD
+ * lanes. The stencil coefficients are generated in registers from four
+ * constants per node (shared by all scenarios) and sigma^2, r - q, r per
+ * scenario, so a node update reads one new value vector only; the
+ * exercise obstacle is shared as well. Prices agree with ExplicitFdSolver::price()
+ * under each model on the same grid up to rounding. Passes are independent
+ * and are handed out across a ThreadPool.
+ *
+ * An explicit grid costs Ns * Nt, and Nt grows with sigma^2 Smax^2, so one
+ * grid for a whole stress set is sized by its most volatile scenario. The
+ * rel_dS overloads bucket instead: scenarios are ordered by the cost of
+ * their own grid and each pass gets the grid of its own scenarios
+ * (makeGrid over the pass), so most passes run on much cheaper grids.
+ */
+class ScenarioPricer {
+public:
+    struct Config {
+        // Scenarios per pass: one AVX-512 vector. The kernel sweeps the grid
+        // once per vector of lanes, so wider passes only add strided traffic.
+        int lanesPerPass = 8;
+    };
+
+    // Scenario x (price, delta, gamma) matrix, one row per scenario
+    struct Result {
+        static constexpr int kColumns = 3;
+
+        int scenarios = 0;
+        std::vector<double> values;   // row-major
+
+        double price(int k) const { return values[kColumns * k]; }
+        double delta(int k) const { return values[kColumns * k + 1]; }
+        double gamma(int k) const { return values[kColumns * k + 2]; }
+    };
+
+    ScenarioPricer() = default;
+    explicit ScenarioPricer(const Config& config, ThreadPool* pool = nullptr);
+
+    // Forces a SIMD level (capped to what the host supports)
+    ScenarioPricer(const Config& config, ThreadPool* pool, stencil::SimdLevel level);
+
+    const Config& config() const { return config_; }
+
+    // Rows in scenario order, one product built per scenario model. The
+    // grid must be stable for every scenario (see makeGrid) and have the
+    // product maturity; the payoff and exercise value must not depend on
+    // the model.
+    Result price(const ProductBuilder& makeProduct,
+                 const std::vector<BlackScholesModel>& scenarios,
+                 const FdGrid& grid,
+                 double S0) const;
+
+    // Library products by type tag (K2: upper strike of spreads, barrier of
+    // knock-outs; continuously monitored only, see makeGrid)
+    Result price(ProductType type, double K1, double K2, double T,
+                 const std::vector<BlackScholesModel>& scenarios,
+                 const FdGrid& grid,
+                 double S0) const;
+
+    // Bucketed: one grid per pass (spatial step rel_dS * S0), scenarios
+    // grouped by the cost of their own grid; rows in scenario order
+    Result price(const ProductBuilder& makeProduct,
+                 const std::vector<BlackScholesModel>& scenarios,
+                 double S0,
+                 double rel_dS) const;
+
+    Result price(ProductType type, double K1, double K2, double T,
+                 const std::vector<BlackScholesModel>& scenarios,
+                 double S0,
+                 double rel_dS) const;
+
+    // Explicit grid for all scenarios: the widest S-domain of
+    // GridParameters::makeGrid (ending on continuously monitored barriers)
+    // and the smallest stable time step
+    static FdGrid makeGrid(const InterfaceProducts& product,
+                           const std::vector<BlackScholesModel>& scenarios,
+                           double S0,
+                           double rel_dS);
+
+    // Additive shocks of a base model, every combination; scenario
+    // (iv, ir, iq) is at index (iv * rateShifts.size() + ir) * dividendShifts.size() + iq
+    static std::vector<BlackScholesModel> shocked(const BlackScholesModel& base,
+                                                  const std::vector<double>& volShifts,
+                                                  const std::vector<double>& rateShifts,
+                                                  const std::vector<double>& dividendShifts);
+
+private:
+    // Runs pass(p), p = 0..passes-1, across the pool if any
+    void runPasses(int passes, const std::function<void(int)>& pass) const;
+
+    Config config_;
+    ThreadPool* pool_ = nullptr;
+    const stencil::Kernels* kernels_ = &stencil::bestKernels();
+};
@@ -1,91 +1,417 @@
-#include "ExplicitFdSolver.hpp" 
+#include "ExplicitFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include "ExplicitFdInterpolation.hpp"
+#include "../products/EuropeanCall.hpp"
+#include "../products/EuropeanPut.hpp"
+#include "../products/AmericanCall.hpp"
+#include "../products/AmericanPut.hpp"
+#include "../products/Future.hpp"
+#include "../products/BullCallSpread.hpp"
+#include "../products/BearPutSpread.hpp"
+#include "../products/Straddle.hpp"
+#include "../products/BarrierOption.hpp"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+ExplicitFdSolver::ExplicitFdSolver()
+    : kernels_(&stencil::bestKernels())
+{
+}
+
+ExplicitFdSolver::ExplicitFdSolver(stencil::SimdLevel level)
+    : kernels_(&stencil::kernels(level))
+{
+}
+
+void ExplicitFdSolver::setThreadPool(ThreadPool* pool, int minNodesPerThread)
+{
+    if (minNodesPerThread < 1) throw std::invalid_argument("minNodesPerThread must be >= 1.");
+    pool_ = pool;
+    minNodesPerThread_ = minNodesPerThread;
+}
+
+void ExplicitFdSolver::setTemporalBlocking(int stepsPerTile, int tileWidth)
+{
+    if (stepsPerTile < 0) throw std::invalid_argument("stepsPerTile must be >= 0.");
+    if (tileWidth < 1) throw std::invalid_argument("tileWidth must be >= 1.");
+    tileDepth_ = stepsPerTile;
+    tileWidth_ = tileWidth;
+}
+
+bool ExplicitFdSolver::useThreadPool(int Ns) const
+{
+    return pool_ && pool_->size() > 1
+        && static_cast<long long>(Ns - 1) >= static_cast<long long>(pool_->size()) * minNodesPerThread_;
+}
+
 ExplicitFdSolver::Result ExplicitFdSolver::price(const InterfaceProducts& option,
                                                 const BlackScholesModel& model,
                                                 const FdGrid& grid,
                                                 double S0) const
 {
+    return price(option, model, grid, S0, SolverWorkspace::threadLocal());
+}
+
+ExplicitFdSolver::Result ExplicitFdSolver::price(const InterfaceProducts& option,
+                                                const BlackScholesModel& model,
+                                                const FdGrid& grid,
+                                                double S0,
+                                                SolverWorkspace& ws,
+                                                bool keepV0) const
+{
+    if (precision_ != Precision::Double && option.monitoringDates().empty())
+        return priceReduced(option, model, grid, S0, ws, keepV0);
+
+    if (auto* p = dynamic_cast<const EuropeanCall*>(&option))   return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const EuropeanPut*>(&option))    return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const AmericanCall*>(&option))   return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const AmericanPut*>(&option))    return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const Future*>(&option))         return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const BullCallSpread*>(&option)) return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const BearPutSpread*>(&option))  return priceProduct(*p, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const Straddle*>(&option))       return priceProduct(*p, model, grid, S0, ws, keepV0);
+
+    // Discrete barrier monitoring: rolled back between monitoring dates
+    if (!option.monitoringDates().empty()) return priceMonitored(option, model, grid, S0, ws, keepV0);
+    if (auto* p = dynamic_cast<const BarrierOption*>(&option))  return priceProduct(*p, model, grid, S0, ws, keepV0);
+
+    return priceGeneric(option, model, grid, S0, ws, keepV0);
+}
+
+ExplicitFdSolver::Result ExplicitFdSolver::priceGeneric(const InterfaceProducts& option,
+                                                       const BlackScholesModel& model,
+                                                       const FdGrid& grid,
+                                                       double S0,
+                                                       SolverWorkspace& ws,
+                                                       bool keepV0) const
+{
+    validateGrid(grid);
+    validateBarrier(option, grid);
+    solver_stats::Timer timer;
+
     const int Ns = grid.Ns();
     const int Nt = grid.Nt();
-    const double dS = grid.dS();
-    const double dt = grid.dt();
+    const auto& S = grid.priceGrid();
+    const bool american = option.isAmerican();
 
-    if (Ns < 2 || Nt < 1) throw std::invalid_argument("Grid too small (Ns<2 or Nt<1).");
-    if (dS <= 0.0 || dt <= 0.0) throw std::invalid_argument("Invalid grid steps (dS<=0 or dt<=0).");
+    ws.prepare(Ns + 1, Nt);
+    coefficients(model, grid, ws.A.data(), ws.B.data(), ws.C.data());
+    fd_kernel::boundaryValues(option, grid, ws.left.data(), ws.right.data());
+    const double setupSeconds = timer.lap();
+    std::int64_t exercised = 0;
+
+    if (useThreadPool(Ns)) {
+        const fd_kernel::Stencil st{ws.A.data(), ws.B.data(), ws.C.data()};
+        auto payoff = [&](int i) { return option.payoff(S[i]); };
+        auto exercise = [&](int i) { return option.earlyExerciseValue(S[i]); };
+
+        std::vector<double> V0 = american
+            ? fd_kernel::parallelRollback<true>(*pool_, *kernels_, st, ws.left.data(), ws.right.data(),
+                                                Ns, Nt, payoff, exercise, &exercised)
+            : fd_kernel::parallelRollback<false>(*pool_, *kernels_, st, ws.left.data(), ws.right.data(),
+                                                 Ns, Nt, payoff, exercise);
+        const double rollbackSeconds = timer.lap();
+        ws.setValues(nullptr, 0);
+        Result res = makeResult(grid, std::move(V0), S0);
+        if constexpr (solver_stats::kEnabled) {
+            fillStats(res.stats, grid, american, exercised, setupSeconds, 0.0, rollbackSeconds, timer.total());
+        }
+        return res;
+    }
+
+    // Terminal condition: V(T,S)=payoff(S)
+    double* V = ws.V.data();
+    for (int i = 0; i <= Ns; ++i) {
+        V[i] = option.payoff(S[i]);
+    }
+
+    if (american) {
+        // Obstacle is time-independent: evaluate the virtual call once per node
+        double* exercise = ws.obstacle.data();
+        for (int i = 0; i <= Ns; ++i) exercise[i] = option.earlyExerciseValue(S[i]);
+    }
+    const double payoffSeconds = timer.lap();
+
+    const int side = option.exerciseSide();
+    const double* V0 = american ? rollback<true>(grid, ws, &exercised, side) : rollback<false>(grid, ws);
+    const double rollbackSeconds = timer.lap();
+
+    ws.setValues(V0, Ns + 1);
+    Result res = makeResult(grid, V0, S0, keepV0);
+    if (american && keepV0 && side != 0 && tileDepth_ <= 1)
+        res.exerciseBoundary.assign(ws.boundary.data(), ws.boundary.data() + Nt);
+    if constexpr (solver_stats::kEnabled) {
+        fillStats(res.stats, grid, american, exercised, setupSeconds, payoffSeconds, rollbackSeconds, timer.total());
+    }
+    return res;
+}
+
+void ExplicitFdSolver::fillStats(SolveStats& stats, const FdGrid& grid, bool american, std::int64_t exercised,
+                                 double setupSeconds, double payoffSeconds, double rollbackSeconds,
+                                 double totalSeconds)
+{
+    const std::int64_t nodes = grid.Ns() + 1;
+    stats.Nt = grid.Nt();
+    stats.Ns = grid.Ns();
+    stats.nodeUpdates = static_cast<std::int64_t>(grid.Ns() - 1) * grid.Nt();
+    stats.exerciseActivations = exercised;
+    stats.payoffCalls = american ? 2 * nodes : nodes;
+    stats.boundaryCalls = 2 * static_cast<std::int64_t>(grid.Nt());
+    stats.setupSeconds = setupSeconds;
+    stats.payoffSeconds = payoffSeconds;
+    stats.rollbackSeconds = rollbackSeconds;
+    stats.totalSeconds = totalSeconds;
+}
+
+std::vector<ExplicitFdSolver::Result>
+ExplicitFdSolver::priceBatch(const std::vector<const InterfaceProducts*>& options,
+                             const BlackScholesModel& model,
+                             const FdGrid& grid,
+                             double S0) const
+{
+    validateGrid(grid);
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const int N  = static_cast<int>(options.size());
 
     const auto& S = grid.priceGrid();
-    const auto& t = grid.timeGrid();
-    if ((int)S.size() != Ns + 1 || (int)t.size() != Nt + 1)
-        throw std::runtime_error("Grid vectors have inconsistent sizes.");
 
-    // Clamp S0 inside the grid to avoid boundary issues for Greeks
-    if (S0 <= S.front()) S0 = S.front() + 1e-12;
-    if (S0 >= S.back())  S0 = S.back()  - 1e-12;
+    for (const InterfaceProducts* option : options) {
+        if (!option) throw std::invalid_argument("Null product in batch.");
+        if (std::fabs(option->maturity() - grid.T()) > 1e-12 * grid.T())
+            throw std::invalid_argument("All products in a batch must have the grid maturity.");
+        validateBarrier(*option, grid);
+    }
 
-    // Cache model params (cleaner + faster)
-    const double r = model.r();
-    const double q = model.q();
-    const double sigma = model.sigma();
-    const double sigma2 = sigma * sigma;
+    std::vector<Result> results;
+    if (N == 0) return results;
 
-    // Terminal condition: V(T,S)=payoff(S)
-    std::vector<double> V(Ns + 1);
-    std::vector<double> Vnew(Ns + 1);
+    const Coefficients coef = coefficients(model, grid);
+
+    // Node-major layout: lane k of node i lives at i*N + k
+    std::vector<double> V(static_cast<std::size_t>(Ns + 1) * N);
+    std::vector<double> Vnew(V.size());
+
+    // Early-exercise obstacle per lane; -inf for European lanes so that a
+    // single branch-free max() serves the whole batch
+    bool anyAmerican = false;
+    std::vector<double> exercise;
+
+    for (int k = 0; k < N; ++k) anyAmerican = anyAmerican || options[k]->isAmerican();
+    if (anyAmerican) exercise.assign(V.size(), -std::numeric_limits<double>::infinity());
 
     for (int i = 0; i <= Ns; ++i) {
-        V[i] = option.payoff(S[i]);
+        for (int k = 0; k < N; ++k) {
+            V[i * N + k] = options[k]->payoff(S[i]);
+            if (options[k]->isAmerican())
+                exercise[i * N + k] = options[k]->earlyExerciseValue(S[i]);
+        }
     }
 
     // Backward time stepping
     for (int n = Nt - 1; n >= 0; --n) {
-        const double tn = t[n];
-        
+        const double tn = grid.time(n);
+
         // Boundaries
-        Vnew[0]  = option.leftBoundary(tn);
-        Vnew[Ns] = option.rightBoundary(tn, S.back());
+        double* VnewLast = Vnew.data() + static_cast<std::size_t>(Ns) * N;
+        for (int k = 0; k < N; ++k) {
+            Vnew[k]     = options[k]->leftBoundary(tn);
+            VnewLast[k] = options[k]->rightBoundary(tn, S.back());
+        }
 
-        // Interior points
+        // Interior points: one coefficient triple per node, N lanes
         for (int i = 1; i < Ns; ++i) {
-            const double Si = S[i];
+            const double A = coef.A[i];
+            const double B = coef.B[i];
+            const double C = coef.C[i];
 
-            const double sig2S2 = sigma2 * Si * Si;
-            const double muS    = (r - q) * Si;
+            const double* Vm = V.data() + static_cast<std::size_t>(i - 1) * N;
+            const double* Vi = Vm + N;
+            const double* Vp = Vi + N;
+            double* out = Vnew.data() + static_cast<std::size_t>(i) * N;
 
-            const double A = 0.5 * dt * ( sig2S2 / (dS * dS) - muS / dS );
-            const double B = 1.0 - dt * ( sig2S2 / (dS * dS) + r );
-            const double C = 0.5 * dt * ( sig2S2 / (dS * dS) + muS / dS );
-
-            double val = A * V[i - 1] + B * V[i] + C * V[i + 1];
-
-            if (option.isAmerican()) {
-                val = std::max(val, option.earlyExerciseValue(Si));
+            for (int k = 0; k < N; ++k) {
+                out[k] = A * Vm[k] + B * Vi[k] + C * Vp[k];
             }
 
-            Vnew[i] = val;
+            if (anyAmerican) {
+                const double* ex = exercise.data() + static_cast<std::size_t>(i) * N;
+                for (int k = 0; k < N; ++k) {
+                    out[k] = std::max(out[k], ex[k]);
+                }
+            }
         }
 
         V.swap(Vnew);
     }
 
-    Result res;
-    res.V0 = V;
-    res.price = grid.interpolate(V, S0);
+    // Scatter lanes back to per-product results
+    results.reserve(N);
+    for (int k = 0; k < N; ++k) {
+        std::vector<double> V0(Ns + 1);
+        for (int i = 0; i <= Ns; ++i) V0[i] = V[i * N + k];
+        results.push_back(makeResult(grid, std::move(V0), S0));
+    }
+    return results;
+}
+
+ExplicitFdSolver::Coefficients ExplicitFdSolver::coefficients(const BlackScholesModel& model,
+                                                             const FdGrid& grid)
+{
+    const int Ns = grid.Ns();
+
+    Coefficients coef;
+    coef.A.assign(Ns + 1, 0.0);
+    coef.B.assign(Ns + 1, 0.0);
+    coef.C.assign(Ns + 1, 0.0);
+
+    coefficients(model, grid, coef.A.data(), coef.B.data(), coef.C.data());
+    return coef;
+}
+
+void ExplicitFdSolver::coefficients(const BlackScholesModel& model, const FdGrid& grid,
+                                    double* A, double* B, double* C)
+{
+    const int Ns = grid.Ns();
+    const double dS = grid.dS();
+    const double dt = grid.dt();
+    const auto& S = grid.priceGrid();
 
-    // -------- Greeks: Delta & Gamma --------
-    // Find i such that S[i] <= S0 < S[i+1]
-    auto it = std::upper_bound(S.begin(), S.end(), S0);
-    int i = static_cast<int>(std::distance(S.begin(), it)) - 1;
+    const double r = model.r();
+    const double q = model.q();
+    const double sigma = model.sigma();
+    const double sigma2 = sigma * sigma;
+
+    // Boundary nodes are Dirichlet: their coefficients are never used
+    A[0] = B[0] = C[0] = 0.0;
+    A[Ns] = B[Ns] = C[Ns] = 0.0;
+
+    if (!grid.uniform()) {
+        // Variable spacing: generic three-point derivative weights
+        for (int i = 1; i < Ns; ++i) {
+            const double Si = S[i];
+            const FdGrid::Weights d = grid.weights(i);
+
+            const double halfSig2S2 = 0.5 * sigma2 * Si * Si;
+            const double muS        = (r - q) * Si;
 
-    // Ensure i-1 and i+1 exist (avoid boundaries)
-    if (i < 1) i = 1;
-    if (i > Ns - 1) i = Ns - 1;
+            A[i] = dt * ( halfSig2S2 * d.d2m + muS * d.d1m );
+            B[i] = 1.0 + dt * ( halfSig2S2 * d.d2c + muS * d.d1c - r );
+            C[i] = dt * ( halfSig2S2 * d.d2p + muS * d.d1p );
+        }
+        return;
+    }
+
+    for (int i = 1; i < Ns; ++i) {
+        const double Si = S[i];
 
-    res.delta = (V[i + 1] - V[i - 1]) / (2.0 * dS);
-    res.gamma = (V[i + 1] - 2.0 * V[i] + V[i - 1]) / (dS * dS);
+        const double sig2S2 = sigma2 * Si * Si;
+        const double muS    = (r - q) * Si;
 
+        A[i] = 0.5 * dt * ( sig2S2 / (dS * dS) - muS / dS );
+        B[i] = 1.0 - dt * ( sig2S2 / (dS * dS) + r );
+        C[i] = 0.5 * dt * ( sig2S2 / (dS * dS) + muS / dS );
+    }
+}
+
+void ExplicitFdSolver::validateGrid(const FdGrid& grid)
+{
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+
+    if (Ns < 2 || Nt < 1) throw std::invalid_argument("Grid too small (Ns<2 or Nt<1).");
+    if (grid.dS() <= 0.0 || grid.dt() <= 0.0) throw std::invalid_argument("Invalid grid steps (dS<=0 or dt<=0).");
+
+    if ((int)grid.priceGrid().size() != Ns + 1)
+        throw std::runtime_error("Grid vectors have inconsistent sizes.");
+}
+
+void ExplicitFdSolver::validateBarrier(const InterfaceProducts& option, const FdGrid& grid, bool monitored)
+{
+    if (!monitored && !option.monitoringDates().empty())
+        throw std::invalid_argument("Discretely monitored barriers need ExplicitFdSolver::price().");
+    if (!option.continuousBarrier()) return;
+
+    // The boundary values are the knock-out values: the domain must end on the barriers
+    const auto& S = grid.priceGrid();
+    const double L = option.lowerBarrier();
+    const double H = option.upperBarrier();
+    if ((L > 0.0 && std::fabs(S.front() - L) > 1e-10 * L) || (std::isfinite(H) && std::fabs(S.back() - H) > 1e-10 * H))
+        throw std::invalid_argument("Continuously monitored barrier must be a grid end (GridParameters builders).");
+}
+
+ExplicitFdSolver::Result ExplicitFdSolver::makeResult(const FdGrid& grid,
+                                                      std::vector<double> V0,
+                                                      double S0)
+{
+    Result res = makeResult(grid, V0.data(), S0, false);
+    res.V0 = std::move(V0);
     return res;
 }
+
+ExplicitFdSolver::Result ExplicitFdSolver::makeResult(const FdGrid& grid,
+                                                      const double* V0,
+                                                      double S0,
+                                                      bool keepV0)
+{
+    Result res;
+    if (keepV0) res.V0.assign(V0, V0 + grid.Ns() + 1);
+
+    solver_stats::Timer timer;
+    double x;
+    int i;
+    fd_interp::bracket(grid, &S0, &x, &i, 1);
+    res.price = fd_interp::interpolatePrice(grid, V0, x, i);
+    res.stats.interpolationSeconds = timer.lap();
+
+    fd_interp::greeks(grid, V0, i, res.delta, res.gamma);
+    res.stats.greeksSeconds = timer.lap();
+    return res;
+}
+
+ExplicitFdSolver::Ladder ExplicitFdSolver::priceLadder(const InterfaceProducts& option,
+                                                      const BlackScholesModel& model,
+                                                      const FdGrid& grid,
+                                                      const std::vector<double>& spots) const
+{
+    if (spots.empty()) throw std::invalid_argument("Spot ladder needs at least one spot.");
+
+    const Result res = price(option, model, grid, spots.front());
+    return ladder(grid, res.V0, spots);
+}
+
+ExplicitFdSolver::Ladder ExplicitFdSolver::ladder(const FdGrid& grid,
+                                                  const std::vector<double>& V,
+                                                  const std::vector<double>& spots)
+{
+    const int Ns = grid.Ns();
+
+    if ((int)V.size() != Ns + 1)
+        throw std::invalid_argument("V must have size Ns+1 to evaluate a ladder on the grid.");
+
+    const int M = static_cast<int>(spots.size());
+
+    Ladder out;
+    out.spots = spots;
+    out.price.resize(M);
+    out.delta.resize(M);
+    out.gamma.resize(M);
+
+    std::vector<double> x(M);
+    std::vector<int> idx(M);
+
+    // 1) Bracket search over all spots (vectorized on uniform grids)
+    fd_interp::bracket(grid, spots.data(), x.data(), idx.data(), M);
+
+    // 2) Interpolation and Greeks
+    for (int m = 0; m < M; ++m) {
+        fd_interp::evaluate(grid, V.data(), x[m], idx[m], out.price[m], out.delta[m], out.gamma[m]);
+    }
+
+    return out;
+}
@@ -0,0 +1,139 @@
+#include "SolverStats.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+// Applies op(field of a, field of b) to every counter and timing of
+// SolveStats; the grid size only with withGrid (an int sum would overflow)
+template <class Op>
+void combine(SolveStats& a, const SolveStats& b, Op op, bool withGrid)
+{
+    if (withGrid) {
+        a.Nt = op(a.Nt, b.Nt);
+        a.Ns = op(a.Ns, b.Ns);
+    }
+    a.nodeUpdates = op(a.nodeUpdates, b.nodeUpdates);
+    a.exerciseActivations = op(a.exerciseActivations, b.exerciseActivations);
+    a.payoffCalls = op(a.payoffCalls, b.payoffCalls);
+    a.boundaryCalls = op(a.boundaryCalls, b.boundaryCalls);
+    a.setupSeconds = op(a.setupSeconds, b.setupSeconds);
+    a.payoffSeconds = op(a.payoffSeconds, b.payoffSeconds);
+    a.rollbackSeconds = op(a.rollbackSeconds, b.rollbackSeconds);
+    a.interpolationSeconds = op(a.interpolationSeconds, b.interpolationSeconds);
+    a.greeksSeconds = op(a.greeksSeconds, b.greeksSeconds);
+    a.totalSeconds = op(a.totalSeconds, b.totalSeconds);
+}
+
+struct Plus {
+    template <class T> T operator()(T a, T b) const { return a + b; }
+};
+
+struct Max {
+    template <class T> T operator()(T a, T b) const { return std::max(a, b); }
+};
+
+} // namespace
+
+StatsRegistry& StatsRegistry::global()
+{
+    static StatsRegistry registry;
+    return registry;
+}
+
+void StatsRegistry::record(const SolveStats& stats, const std::string& tag)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++count_;
+    sumNt_ += stats.Nt;
+    sumNs_ += stats.Ns;
+    combine(sum_, stats, Plus(), false);
+    combine(max_, stats, Max(), true);
+
+    if (keepSlowest_ == 0) return;
+    auto slower = [](const Entry& a, const Entry& b) { return a.stats.totalSeconds > b.stats.totalSeconds; };
+    if (slowest_.size() == keepSlowest_) {
+        if (stats.totalSeconds <= slowest_.back().stats.totalSeconds) return;
+        slowest_.pop_back();
+    }
+    const Entry entry{tag, stats};
+    slowest_.insert(std::upper_bound(slowest_.begin(), slowest_.end(), entry, slower), entry);
+}
+
+void StatsRegistry::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    count_ = 0;
+    sumNt_ = sumNs_ = 0;
+    sum_ = SolveStats();
+    max_ = SolveStats();
+    slowest_.clear();
+}
+
+std::size_t StatsRegistry::count() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+SolveStats StatsRegistry::sum() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sum_;
+}
+
+SolveStats StatsRegistry::max() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_;
+}
+
+double StatsRegistry::meanNt() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_ ? static_cast<double>(sumNt_) / count_ : 0.0;
+}
+
+double StatsRegistry::meanNs() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_ ? static_cast<double>(sumNs_) / count_ : 0.0;
+}
+
+std::vector<StatsRegistry::Entry> StatsRegistry::slowest() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slowest_;
+}
+
+void StatsRegistry::dump(std::ostream& out) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const double n = count_ ? static_cast<double>(count_) : 1.0;
+
+    out << "=== Solver stats (" << count_ << " solves) ===\n";
+    out << std::fixed << std::setprecision(3);
+    out << "time (ms)   total " << sum_.totalSeconds * 1e3
+        << "  setup " << sum_.setupSeconds * 1e3
+        << "  payoff " << sum_.payoffSeconds * 1e3
+        << "  rollback " << sum_.rollbackSeconds * 1e3
+        << "  interpolation " << sum_.interpolationSeconds * 1e3
+        << "  greeks " << sum_.greeksSeconds * 1e3 << "\n";
+    out << "per solve   " << sum_.totalSeconds / n * 1e3 << " ms mean, " << max_.totalSeconds * 1e3 << " ms max"
+        << "  Nt " << sumNt_ / n << " mean / " << max_.Nt << " max"
+        << "  Ns " << sumNs_ / n << " mean / " << max_.Ns << " max\n";
+    out << "counters    node updates " << sum_.nodeUpdates
+        << "  exercise activations " << sum_.exerciseActivations
+        << "  payoff calls " << sum_.payoffCalls
+        << "  boundary calls " << sum_.boundaryCalls << "\n";
+
+    if (!slowest_.empty()) out << "slowest solves:\n";
+    for (const Entry& e : slowest_) {
+        const SolveStats& s = e.stats;
+        out << "  " << std::setw(12) << std::left << e.tag << std::right
+            << "  " << s.totalSeconds * 1e3 << " ms  Nt=" << s.Nt << " Ns=" << s.Ns
+            << "  rollback " << s.rollbackSeconds * 1e3 << " ms"
+            << "  exercised " << (s.nodeUpdates ? 100.0 * s.exerciseActivations / s.nodeUpdates : 0.0) << "%\n";
+    }
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Build with -DBS_SOLVER_STATS=1 (CMake option BS_SOLVER_STATS) to fill
+// SolveStats; by default all instrumentation compiles away.
+#ifndef BS_SOLVER_STATS
+#define BS_SOLVER_STATS 0
+#endif
+
+/**
+ * Per-solve counters and phase timings of ExplicitFdSolver, returned in
+ * Result::stats. All fields stay zero unless built with BS_SOLVER_STATS.
+ * Other solvers built on ExplicitFdSolver::makeResult only fill the
+ * interpolation and Greeks timings.
+ */
+struct SolveStats {
+    int Nt = 0;
+    int Ns = 0;
+    std::int64_t nodeUpdates = 0;          // interior node updates, (Ns-1)*Nt
+    std::int64_t exerciseActivations = 0;  // (node, step) pairs where the obstacle won
+    std::int64_t payoffCalls = 0;          // payoff + earlyExerciseValue evaluations
+    std::int64_t boundaryCalls = 0;        // leftBoundary + rightBoundary evaluations
+
+    double setupSeconds = 0.0;             // stencil coefficients + boundary values
+    double payoffSeconds = 0.0;            // terminal payoff and obstacle
+    double rollbackSeconds = 0.0;          // time stepping
+    double interpolationSeconds = 0.0;     // bracket search + price at S0
+    double greeksSeconds = 0.0;            // delta, gamma
+    double totalSeconds = 0.0;
+};
+
+namespace solver_stats {
+
+constexpr bool kEnabled = BS_SOLVER_STATS != 0;
+
+// Lap timer; reads no clock at all when stats are disabled
+class Timer {
+public:
+    Timer() { if constexpr (kEnabled) last_ = start_ = std::chrono::steady_clock::now(); }
+
+    // Seconds since the previous lap (or construction)
+    double lap() {
+        if constexpr (kEnabled) {
+            const auto now = std::chrono::steady_clock::now();
+            const double s = std::chrono::duration<double>(now - last_).count();
+            last_ = now;
+            return s;
+        }
+        return 0.0;
+    }
+
+    // Seconds since construction
+    double total() const {
+        if constexpr (kEnabled) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        }
+        return 0.0;
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_, last_;
+};
+
+} // namespace solver_stats
+
+/**
+ * Thread-safe aggregate of recorded solves: count, sums and maxima of every
+ * field, and the slowest solves (by totalSeconds) with a caller tag, so a
+ * batch run can point at its pathological trades.
+ */
+class StatsRegistry {
+public:
+    struct Entry {
+        std::string tag;
+        SolveStats stats;
+    };
+
+    explicit StatsRegistry(std::size_t keepSlowest = 10) : keepSlowest_(keepSlowest) {}
+
+    static StatsRegistry& global();
+
+    void record(const SolveStats& stats, const std::string& tag);
+    void reset();
+
+    std::size_t count() const;
+    SolveStats sum() const;                 // Nt and Ns left 0: see meanNt/meanNs
+    SolveStats max() const;
+    double meanNt() const;
+    double meanNs() const;
+    std::vector<Entry> slowest() const;     // slowest first
+
+    // Human-readable summary: totals, means, maxima, slowest solves
+    void dump(std::ostream& out) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::size_t keepSlowest_;
+    std::size_t count_ = 0;
+    std::int64_t sumNt_ = 0, sumNs_ = 0;
+    SolveStats sum_, max_;
+    std::vector<Entry> slowest_;
+};
@@ -0,0 +1,131 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Minimal aligned allocator (cache-line / AVX-512 friendly buffers)
+ */
+template <class T, std::size_t Alignment>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <class U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+/**
+ * Reusable buffers of the grid solvers (values, stencil coefficients,
+ * obstacle, boundary values, tiling scratch, tridiagonal factors,
+ * early-exercise boundary, float buffers of the reduced-precision sweeps).
+ * Buffers grow to the largest grid seen and never shrink, so once warm a
+ * solve performs no heap allocation. One workspace per thread: either pass
+ * one explicitly or use threadLocal().
+ */
+class SolverWorkspace {
+public:
+    using Buffer = std::vector<double, AlignedAllocator<double, 64>>;
+    using FloatBuffer = std::vector<float, AlignedAllocator<float, 64>>;
+
+    // Grows the buffers for a grid with `nodes` S-nodes and `timeSteps` steps
+    void prepare(int nodes, int timeSteps) {
+        grow(V, nodes);
+        grow(Vnew, nodes);
+        grow(A, nodes);
+        grow(B, nodes);
+        grow(C, nodes);
+        grow(obstacle, nodes);
+        grow(left, timeSteps);
+        grow(right, timeSteps);
+    }
+
+    // Scratch for temporal blocking (two tiles with halo)
+    void prepareScratch(int size) {
+        grow(scratchA, size);
+        grow(scratchB, size);
+    }
+
+    // Early-exercise boundary, one value per time level
+    void prepareBoundary(int timeSteps) {
+        grow(boundary, timeSteps);
+    }
+
+    // Theta-scheme: LU factors of the full and half steps (3 arrays each)
+    // and the right-hand side, laid out contiguously
+    void prepareTridiag(int nodes) {
+        grow(tridiag, 7 * nodes);
+    }
+
+    // Reduced-precision explicit sweeps: float values, plus float
+    // coefficients (A, C, D) and obstacle in Float mode
+    void prepareFloat(int nodes, bool coefficients) {
+        grow(Vf, nodes);
+        grow(Vnewf, nodes);
+        if (!coefficients) return;
+        grow(Af, nodes);
+        grow(Cf, nodes);
+        grow(Df, nodes);
+        grow(obstaclef, nodes);
+    }
+
+    // t=0 values of the last solve on this workspace (valid until the next
+    // solve); lets callers skip the Result::V0 copy
+    const double* values() const { return values_; }
+    int valueCount() const { return valueCount_; }
+
+    void setValues(const double* values, int count) {
+        values_ = values;
+        valueCount_ = count;
+    }
+
+    // Bytes currently held
+    std::size_t capacityBytes() const {
+        return sizeof(double) * (V.capacity() + Vnew.capacity() + A.capacity() + B.capacity()
+                                 + C.capacity() + obstacle.capacity() + left.capacity()
+                                 + right.capacity() + scratchA.capacity() + scratchB.capacity()
+                                 + tridiag.capacity() + boundary.capacity())
+             + sizeof(float) * (Vf.capacity() + Vnewf.capacity() + Af.capacity() + Cf.capacity()
+                                + Df.capacity() + obstaclef.capacity());
+    }
+
+    static SolverWorkspace& threadLocal() {
+        thread_local SolverWorkspace ws;
+        return ws;
+    }
+
+    Buffer V, Vnew;
+    Buffer A, B, C;
+    Buffer obstacle;
+    Buffer left, right;
+    Buffer scratchA, scratchB;
+    Buffer tridiag;
+    Buffer boundary;
+    FloatBuffer Vf, Vnewf;
+    FloatBuffer Af, Cf, Df;
+    FloatBuffer obstaclef;
+
+private:
+    template <class Vec>
+    static void grow(Vec& b, int n) {
+        if (static_cast<std::size_t>(n) > b.size()) b.resize(n);
+    }
+
+    const double* values_ = nullptr;
+    int valueCount_ = 0;
+};
@@ -0,0 +1,939 @@
+#include "StencilKernels.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// Keep mul + add separate in every kernel (AVX-512 targets imply FMA), so that
+// all levels round exactly like the scalar reference
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define BS_STENCIL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace stencil {
+namespace {
+
+// ---------------- Scalar reference ----------------
+
+void stepScalar(const double* A, const double* B, const double* C,
+                const double* v, double* out, int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        out[i] = A[i] * v[i - 1] + B[i] * v[i] + C[i] * v[i + 1];
+    }
+}
+
+void stepAmericanScalar(const double* A, const double* B, const double* C,
+                        const double* v, const double* obstacle, double* out,
+                        int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const double val = A[i] * v[i - 1] + B[i] * v[i] + C[i] * v[i + 1];
+        out[i] = std::max(val, obstacle[i]);
+    }
+}
+
+void stepConstScalar(double a, double b, double c,
+                     const double* v, double* out, int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        out[i] = a * v[i - 1] + b * v[i] + c * v[i + 1];
+    }
+}
+
+void stepConstAmericanScalar(double a, double b, double c,
+                             const double* v, const double* obstacle, double* out,
+                             int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const double val = a * v[i - 1] + b * v[i] + c * v[i + 1];
+        out[i] = std::max(val, obstacle[i]);
+    }
+}
+
+
+// Lane kernels: lanes [k0, lanes) rolled through nodes [begin, end) one by
+// one (a lane's neighbours are `lanes` apart). The SIMD versions take one
+// vector of lanes at a time through the nodes, with its lane constants and
+// its left/centre values kept in registers, and leave the remaining lanes
+// to this tail
+inline void stepLanesTail(const double* g, const double* s, const double* m, const double* b0,
+                          const double* v, const double* obstacle, double* out,
+                          int lanes, int k0, int begin, int end)
+{
+    for (int k = k0; k < lanes; ++k) {
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const double* vi = v + static_cast<long>(i) * lanes + k;
+            const double A = s[k] * gi[0] + m[k] * gi[1];
+            const double C = s[k] * gi[2] + m[k] * gi[3];
+            const double B = b0[k] - (A + C);
+            const double val = A * vi[-lanes] + B * vi[0] + C * vi[lanes];
+            out[static_cast<long>(i) * lanes + k] = obstacle ? std::max(val, obstacle[i]) : val;
+        }
+    }
+}
+
+void stepLanesScalar(const double* g, const double* s, const double* m, const double* b0,
+                     const double* v, double* out, int lanes, int begin, int end)
+{
+    stepLanesTail(g, s, m, b0, v, nullptr, out, lanes, 0, begin, end);
+}
+
+void stepLanesAmericanScalar(const double* g, const double* s, const double* m, const double* b0,
+                             const double* v, const double* obstacle, double* out,
+                             int lanes, int begin, int end)
+{
+    stepLanesTail(g, s, m, b0, v, obstacle, out, lanes, 0, begin, end);
+}
+
+// Reduced precision: float increment form, and double arithmetic on float values
+
+void stepFloatScalar(const float* A, const float* C, const float* D,
+                     const float* v, float* out, int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const float inc = (A[i] * (v[i - 1] - v[i]) + C[i] * (v[i + 1] - v[i])) - D[i] * v[i];
+        out[i] = v[i] + inc;
+    }
+}
+
+void stepFloatAmericanScalar(const float* A, const float* C, const float* D,
+                             const float* v, const float* obstacle, float* out,
+                             int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const float inc = (A[i] * (v[i - 1] - v[i]) + C[i] * (v[i + 1] - v[i])) - D[i] * v[i];
+        out[i] = std::max(v[i] + inc, obstacle[i]);
+    }
+}
+
+void stepMixedScalar(const double* A, const double* B, const double* C,
+                     const float* v, float* out, int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const double val = A[i] * double(v[i - 1]) + B[i] * double(v[i]) + C[i] * double(v[i + 1]);
+        out[i] = static_cast<float>(val);
+    }
+}
+
+void stepMixedAmericanScalar(const double* A, const double* B, const double* C,
+                             const float* v, const double* obstacle, float* out,
+                             int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        const double val = A[i] * double(v[i - 1]) + B[i] * double(v[i]) + C[i] * double(v[i + 1]);
+        out[i] = static_cast<float>(std::max(val, obstacle[i]));
+    }
+}
+
+// Bracket search on a uniform grid S[0..Ns] (spot ladders): spots
+// [begin, end) clamped inside [S[0], S[Ns]] by 1e-12 into x, and idx[m] in
+// [0, Ns-1] with S[i] <= x < S[i+1] (x = S[Ns] when the clamp rounds back
+// onto it). Direct index (x - S[0]) / dS clamped in double, then a
+// one-node correction for rounding
+inline void bracketTail(const double* S, int Ns, double dS,
+                        const double* spots, double* x, int* idx, int begin, int end)
+{
+    const double top = Ns - 1;
+    for (int m = begin; m < end; ++m) {
+        const double sm = spots[m];
+        const double xm = sm <= S[0] ? S[0] + 1e-12 : (sm >= S[Ns] ? S[Ns] - 1e-12 : sm);
+        double q = (xm - S[0]) / dS;
+        q = q > 0.0 ? q : 0.0;
+        q = q < top ? q : top;
+        int i = static_cast<int>(q);
+        if (xm < S[i])           --i;
+        else if (xm >= S[i + 1]) ++i;
+        x[m] = xm;
+        idx[m] = std::min(std::max(i, 0), Ns - 1);
+    }
+}
+
+void bracketScalar(const double* S, int Ns, double dS,
+                   const double* spots, double* x, int* idx, int n)
+{
+    bracketTail(S, Ns, dS, spots, x, idx, 0, n);
+}
+
+#ifdef BS_STENCIL_X86
+
+// Note on max: _mm*_max_pd(a, b) returns b unless a > b, so max_pd(obstacle, val)
+// reproduces std::max(val, obstacle) exactly (ties and NaN included); same
+// for _mm*_max_ps.
+
+// ---------------- SSE2 (2 lanes) ----------------
+
+__attribute__((target("sse2")))
+void stepSSE2(const double* A, const double* B, const double* C,
+              const double* v, double* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + i), _mm_loadu_pd(v + i - 1)),
+                                 _mm_mul_pd(_mm_loadu_pd(B + i), _mm_loadu_pd(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(_mm_loadu_pd(C + i), _mm_loadu_pd(v + i + 1)));
+        _mm_storeu_pd(out + i, val);
+    }
+    stepScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepAmericanSSE2(const double* A, const double* B, const double* C,
+                      const double* v, const double* obstacle, double* out,
+                      int begin, int end)
+{
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + i), _mm_loadu_pd(v + i - 1)),
+                                 _mm_mul_pd(_mm_loadu_pd(B + i), _mm_loadu_pd(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(_mm_loadu_pd(C + i), _mm_loadu_pd(v + i + 1)));
+        _mm_storeu_pd(out + i, _mm_max_pd(_mm_loadu_pd(obstacle + i), val));
+    }
+    stepAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepConstSSE2(double a, double b, double c,
+                   const double* v, double* out, int begin, int end)
+{
+    const __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b), vc = _mm_set1_pd(c);
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(v + i - 1)),
+                                 _mm_mul_pd(vb, _mm_loadu_pd(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(vc, _mm_loadu_pd(v + i + 1)));
+        _mm_storeu_pd(out + i, val);
+    }
+    stepConstScalar(a, b, c, v, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepConstAmericanSSE2(double a, double b, double c,
+                           const double* v, const double* obstacle, double* out,
+                           int begin, int end)
+{
+    const __m128d va = _mm_set1_pd(a), vb = _mm_set1_pd(b), vc = _mm_set1_pd(c);
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(v + i - 1)),
+                                 _mm_mul_pd(vb, _mm_loadu_pd(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(vc, _mm_loadu_pd(v + i + 1)));
+        _mm_storeu_pd(out + i, _mm_max_pd(_mm_loadu_pd(obstacle + i), val));
+    }
+    stepConstAmericanScalar(a, b, c, v, obstacle, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepLanesSSE2(const double* g, const double* s, const double* m, const double* b0,
+                   const double* v, double* out, int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 2 <= lanes; k += 2) {
+        const __m128d ls = _mm_loadu_pd(s + k), lm = _mm_loadu_pd(m + k), lb = _mm_loadu_pd(b0 + k);
+        __m128d vl = _mm_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m128d vc = _mm_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m128d vr = _mm_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m128d A = _mm_add_pd(_mm_mul_pd(ls, _mm_set1_pd(gi[0])),
+                                         _mm_mul_pd(lm, _mm_set1_pd(gi[1])));
+            const __m128d C = _mm_add_pd(_mm_mul_pd(ls, _mm_set1_pd(gi[2])),
+                                         _mm_mul_pd(lm, _mm_set1_pd(gi[3])));
+            const __m128d B = _mm_sub_pd(lb, _mm_add_pd(A, C));
+            __m128d val = _mm_add_pd(_mm_mul_pd(A, vl), _mm_mul_pd(B, vc));
+            val = _mm_add_pd(val, _mm_mul_pd(C, vr));
+            _mm_storeu_pd(out + static_cast<long>(i) * lanes + k, val);
+            vl = vc;
+            vc = vr;
+        }
+    }
+    stepLanesTail(g, s, m, b0, v, nullptr, out, lanes, k, begin, end);
+}
+
+__attribute__((target("sse2")))
+void stepLanesAmericanSSE2(const double* g, const double* s, const double* m, const double* b0,
+                           const double* v, const double* obstacle, double* out,
+                           int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 2 <= lanes; k += 2) {
+        const __m128d ls = _mm_loadu_pd(s + k), lm = _mm_loadu_pd(m + k), lb = _mm_loadu_pd(b0 + k);
+        __m128d vl = _mm_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m128d vc = _mm_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m128d vr = _mm_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m128d A = _mm_add_pd(_mm_mul_pd(ls, _mm_set1_pd(gi[0])),
+                                         _mm_mul_pd(lm, _mm_set1_pd(gi[1])));
+            const __m128d C = _mm_add_pd(_mm_mul_pd(ls, _mm_set1_pd(gi[2])),
+                                         _mm_mul_pd(lm, _mm_set1_pd(gi[3])));
+            const __m128d B = _mm_sub_pd(lb, _mm_add_pd(A, C));
+            __m128d val = _mm_add_pd(_mm_mul_pd(A, vl), _mm_mul_pd(B, vc));
+            val = _mm_add_pd(val, _mm_mul_pd(C, vr));
+            _mm_storeu_pd(out + static_cast<long>(i) * lanes + k, _mm_max_pd(_mm_set1_pd(obstacle[i]), val));
+            vl = vc;
+            vc = vr;
+        }
+    }
+    stepLanesTail(g, s, m, b0, v, obstacle, out, lanes, k, begin, end);
+}
+
+// Two floats widened to doubles / narrowed back (mixed kernels)
+__attribute__((target("sse2")))
+inline __m128d loadFloat2(const float* p)
+{
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p))));
+}
+
+__attribute__((target("sse2")))
+inline void storeFloat2(float* p, __m128d x)
+{
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_castps_si128(_mm_cvtpd_ps(x)));
+}
+
+__attribute__((target("sse2")))
+void stepFloatSSE2(const float* A, const float* C, const float* D,
+                   const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 vc = _mm_loadu_ps(v + i);
+        __m128 inc = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(A + i), _mm_sub_ps(_mm_loadu_ps(v + i - 1), vc)),
+                                _mm_mul_ps(_mm_loadu_ps(C + i), _mm_sub_ps(_mm_loadu_ps(v + i + 1), vc)));
+        inc = _mm_sub_ps(inc, _mm_mul_ps(_mm_loadu_ps(D + i), vc));
+        _mm_storeu_ps(out + i, _mm_add_ps(vc, inc));
+    }
+    stepFloatScalar(A, C, D, v, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepFloatAmericanSSE2(const float* A, const float* C, const float* D,
+                           const float* v, const float* obstacle, float* out,
+                           int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m128 vc = _mm_loadu_ps(v + i);
+        __m128 inc = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(A + i), _mm_sub_ps(_mm_loadu_ps(v + i - 1), vc)),
+                                _mm_mul_ps(_mm_loadu_ps(C + i), _mm_sub_ps(_mm_loadu_ps(v + i + 1), vc)));
+        inc = _mm_sub_ps(inc, _mm_mul_ps(_mm_loadu_ps(D + i), vc));
+        _mm_storeu_ps(out + i, _mm_max_ps(_mm_loadu_ps(obstacle + i), _mm_add_ps(vc, inc)));
+    }
+    stepFloatAmericanScalar(A, C, D, v, obstacle, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepMixedSSE2(const double* A, const double* B, const double* C,
+                   const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + i), loadFloat2(v + i - 1)),
+                                 _mm_mul_pd(_mm_loadu_pd(B + i), loadFloat2(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(_mm_loadu_pd(C + i), loadFloat2(v + i + 1)));
+        storeFloat2(out + i, val);
+    }
+    stepMixedScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("sse2")))
+void stepMixedAmericanSSE2(const double* A, const double* B, const double* C,
+                           const float* v, const double* obstacle, float* out,
+                           int begin, int end)
+{
+    int i = begin;
+    for (; i + 2 <= end; i += 2) {
+        __m128d val = _mm_add_pd(_mm_mul_pd(_mm_loadu_pd(A + i), loadFloat2(v + i - 1)),
+                                 _mm_mul_pd(_mm_loadu_pd(B + i), loadFloat2(v + i)));
+        val = _mm_add_pd(val, _mm_mul_pd(_mm_loadu_pd(C + i), loadFloat2(v + i + 1)));
+        val = _mm_max_pd(_mm_loadu_pd(obstacle + i), val);
+        storeFloat2(out + i, val);
+    }
+    stepMixedAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+// Bracket: the clamps run in double (max_pd(q, 0) / min_pd(q, top) as the
+// scalar selects) and the correction moves the index by +-1 in double, so
+// every lane reproduces bracketTail
+__attribute__((target("sse2")))
+void bracketSSE2(const double* S, int Ns, double dS,
+                 const double* spots, double* x, int* idx, int n)
+{
+    const __m128d s0 = _mm_set1_pd(S[0]), sN = _mm_set1_pd(S[Ns]);
+    const __m128d lo = _mm_set1_pd(S[0] + 1e-12), hi = _mm_set1_pd(S[Ns] - 1e-12);
+    const __m128d h = _mm_set1_pd(dS), zero = _mm_setzero_pd();
+    const __m128d top = _mm_set1_pd(Ns - 1), one = _mm_set1_pd(1.0);
+    int m = 0;
+    for (; m + 2 <= n; m += 2) {
+        const __m128d sm = _mm_loadu_pd(spots + m);
+        const __m128d ge = _mm_cmpge_pd(sm, sN), le = _mm_cmple_pd(sm, s0);
+        __m128d xv = _mm_or_pd(_mm_and_pd(ge, hi), _mm_andnot_pd(ge, sm));
+        xv = _mm_or_pd(_mm_and_pd(le, lo), _mm_andnot_pd(le, xv));
+        const __m128d q = _mm_min_pd(_mm_max_pd(_mm_div_pd(_mm_sub_pd(xv, s0), h), zero), top);
+        const __m128i i = _mm_cvttpd_epi32(q);
+        // S[i], S[i+1] of both lanes (no gather in SSE2)
+        const __m128d n0 = _mm_loadu_pd(S + _mm_cvtsi128_si32(i));
+        const __m128d n1 = _mm_loadu_pd(S + _mm_cvtsi128_si32(_mm_shuffle_epi32(i, 1)));
+        const __m128d lt = _mm_cmplt_pd(xv, _mm_unpacklo_pd(n0, n1));
+        const __m128d up = _mm_andnot_pd(lt, _mm_cmpge_pd(xv, _mm_unpackhi_pd(n0, n1)));
+        __m128d qi = _mm_add_pd(_mm_sub_pd(_mm_cvtepi32_pd(i), _mm_and_pd(lt, one)), _mm_and_pd(up, one));
+        qi = _mm_min_pd(_mm_max_pd(qi, zero), top);
+        _mm_storeu_pd(x + m, xv);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(idx + m), _mm_cvttpd_epi32(qi));
+    }
+    bracketTail(S, Ns, dS, spots, x, idx, m, n);
+}
+
+// ---------------- AVX2 (4 lanes) ----------------
+
+// The scalar tails are SSE code: clear the upper halves before calling them
+// (at -O2 GCC turns the calls into tail jumps without vzeroupper, and every
+// SSE instruction after them pays an AVX-SSE transition)
+
+__attribute__((target("avx2")))
+void stepAVX2(const double* A, const double* B, const double* C,
+              const double* v, double* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(A + i), _mm256_loadu_pd(v + i - 1)),
+                                    _mm256_mul_pd(_mm256_loadu_pd(B + i), _mm256_loadu_pd(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(_mm256_loadu_pd(C + i), _mm256_loadu_pd(v + i + 1)));
+        _mm256_storeu_pd(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepAmericanAVX2(const double* A, const double* B, const double* C,
+                      const double* v, const double* obstacle, double* out,
+                      int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(A + i), _mm256_loadu_pd(v + i - 1)),
+                                    _mm256_mul_pd(_mm256_loadu_pd(B + i), _mm256_loadu_pd(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(_mm256_loadu_pd(C + i), _mm256_loadu_pd(v + i + 1)));
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_loadu_pd(obstacle + i), val));
+    }
+    _mm256_zeroupper();
+    stepAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepConstAVX2(double a, double b, double c,
+                   const double* v, double* out, int begin, int end)
+{
+    const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b), vc = _mm256_set1_pd(c);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(va, _mm256_loadu_pd(v + i - 1)),
+                                    _mm256_mul_pd(vb, _mm256_loadu_pd(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(vc, _mm256_loadu_pd(v + i + 1)));
+        _mm256_storeu_pd(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepConstScalar(a, b, c, v, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepConstAmericanAVX2(double a, double b, double c,
+                           const double* v, const double* obstacle, double* out,
+                           int begin, int end)
+{
+    const __m256d va = _mm256_set1_pd(a), vb = _mm256_set1_pd(b), vc = _mm256_set1_pd(c);
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(va, _mm256_loadu_pd(v + i - 1)),
+                                    _mm256_mul_pd(vb, _mm256_loadu_pd(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(vc, _mm256_loadu_pd(v + i + 1)));
+        _mm256_storeu_pd(out + i, _mm256_max_pd(_mm256_loadu_pd(obstacle + i), val));
+    }
+    _mm256_zeroupper();
+    stepConstAmericanScalar(a, b, c, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepLanesAVX2(const double* g, const double* s, const double* m, const double* b0,
+                   const double* v, double* out, int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 4 <= lanes; k += 4) {
+        const __m256d ls = _mm256_loadu_pd(s + k), lm = _mm256_loadu_pd(m + k), lb = _mm256_loadu_pd(b0 + k);
+        __m256d vl = _mm256_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m256d vc = _mm256_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m256d vr = _mm256_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m256d A = _mm256_add_pd(_mm256_mul_pd(ls, _mm256_set1_pd(gi[0])),
+                                            _mm256_mul_pd(lm, _mm256_set1_pd(gi[1])));
+            const __m256d C = _mm256_add_pd(_mm256_mul_pd(ls, _mm256_set1_pd(gi[2])),
+                                            _mm256_mul_pd(lm, _mm256_set1_pd(gi[3])));
+            const __m256d B = _mm256_sub_pd(lb, _mm256_add_pd(A, C));
+            __m256d val = _mm256_add_pd(_mm256_mul_pd(A, vl), _mm256_mul_pd(B, vc));
+            val = _mm256_add_pd(val, _mm256_mul_pd(C, vr));
+            _mm256_storeu_pd(out + static_cast<long>(i) * lanes + k, val);
+            vl = vc;
+            vc = vr;
+        }
+    }
+    _mm256_zeroupper();
+    stepLanesTail(g, s, m, b0, v, nullptr, out, lanes, k, begin, end);
+}
+
+__attribute__((target("avx2")))
+void stepLanesAmericanAVX2(const double* g, const double* s, const double* m, const double* b0,
+                           const double* v, const double* obstacle, double* out,
+                           int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 4 <= lanes; k += 4) {
+        const __m256d ls = _mm256_loadu_pd(s + k), lm = _mm256_loadu_pd(m + k), lb = _mm256_loadu_pd(b0 + k);
+        __m256d vl = _mm256_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m256d vc = _mm256_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m256d vr = _mm256_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m256d A = _mm256_add_pd(_mm256_mul_pd(ls, _mm256_set1_pd(gi[0])),
+                                            _mm256_mul_pd(lm, _mm256_set1_pd(gi[1])));
+            const __m256d C = _mm256_add_pd(_mm256_mul_pd(ls, _mm256_set1_pd(gi[2])),
+                                            _mm256_mul_pd(lm, _mm256_set1_pd(gi[3])));
+            const __m256d B = _mm256_sub_pd(lb, _mm256_add_pd(A, C));
+            __m256d val = _mm256_add_pd(_mm256_mul_pd(A, vl), _mm256_mul_pd(B, vc));
+            val = _mm256_add_pd(val, _mm256_mul_pd(C, vr));
+            _mm256_storeu_pd(out + static_cast<long>(i) * lanes + k, _mm256_max_pd(_mm256_set1_pd(obstacle[i]), val));
+            vl = vc;
+            vc = vr;
+        }
+    }
+    _mm256_zeroupper();
+    stepLanesTail(g, s, m, b0, v, obstacle, out, lanes, k, begin, end);
+}
+
+__attribute__((target("avx2")))
+inline __m256d loadFloat4(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+
+__attribute__((target("avx2")))
+inline void storeFloat4(float* p, __m256d x) { _mm_storeu_ps(p, _mm256_cvtpd_ps(x)); }
+
+__attribute__((target("avx2")))
+void stepFloatAVX2(const float* A, const float* C, const float* D,
+                   const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 vc = _mm256_loadu_ps(v + i);
+        __m256 inc = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(A + i), _mm256_sub_ps(_mm256_loadu_ps(v + i - 1), vc)),
+                                   _mm256_mul_ps(_mm256_loadu_ps(C + i), _mm256_sub_ps(_mm256_loadu_ps(v + i + 1), vc)));
+        inc = _mm256_sub_ps(inc, _mm256_mul_ps(_mm256_loadu_ps(D + i), vc));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(vc, inc));
+    }
+    _mm256_zeroupper();
+    stepFloatScalar(A, C, D, v, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepFloatAmericanAVX2(const float* A, const float* C, const float* D,
+                           const float* v, const float* obstacle, float* out,
+                           int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256 vc = _mm256_loadu_ps(v + i);
+        __m256 inc = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(A + i), _mm256_sub_ps(_mm256_loadu_ps(v + i - 1), vc)),
+                                   _mm256_mul_ps(_mm256_loadu_ps(C + i), _mm256_sub_ps(_mm256_loadu_ps(v + i + 1), vc)));
+        inc = _mm256_sub_ps(inc, _mm256_mul_ps(_mm256_loadu_ps(D + i), vc));
+        _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_loadu_ps(obstacle + i), _mm256_add_ps(vc, inc)));
+    }
+    _mm256_zeroupper();
+    stepFloatAmericanScalar(A, C, D, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepMixedAVX2(const double* A, const double* B, const double* C,
+                   const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(A + i), loadFloat4(v + i - 1)),
+                                    _mm256_mul_pd(_mm256_loadu_pd(B + i), loadFloat4(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(_mm256_loadu_pd(C + i), loadFloat4(v + i + 1)));
+        storeFloat4(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepMixedScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void stepMixedAmericanAVX2(const double* A, const double* B, const double* C,
+                           const float* v, const double* obstacle, float* out,
+                           int begin, int end)
+{
+    int i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d val = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(A + i), loadFloat4(v + i - 1)),
+                                    _mm256_mul_pd(_mm256_loadu_pd(B + i), loadFloat4(v + i)));
+        val = _mm256_add_pd(val, _mm256_mul_pd(_mm256_loadu_pd(C + i), loadFloat4(v + i + 1)));
+        val = _mm256_max_pd(_mm256_loadu_pd(obstacle + i), val);
+        storeFloat4(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepMixedAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx2")))
+void bracketAVX2(const double* S, int Ns, double dS,
+                 const double* spots, double* x, int* idx, int n)
+{
+    const __m256d s0 = _mm256_set1_pd(S[0]), sN = _mm256_set1_pd(S[Ns]);
+    const __m256d lo = _mm256_set1_pd(S[0] + 1e-12), hi = _mm256_set1_pd(S[Ns] - 1e-12);
+    const __m256d h = _mm256_set1_pd(dS), zero = _mm256_setzero_pd();
+    const __m256d top = _mm256_set1_pd(Ns - 1), one = _mm256_set1_pd(1.0);
+    int m = 0;
+    for (; m + 4 <= n; m += 4) {
+        const __m256d sm = _mm256_loadu_pd(spots + m);
+        __m256d xv = _mm256_blendv_pd(sm, hi, _mm256_cmp_pd(sm, sN, _CMP_GE_OQ));
+        xv = _mm256_blendv_pd(xv, lo, _mm256_cmp_pd(sm, s0, _CMP_LE_OQ));
+        const __m256d q = _mm256_min_pd(_mm256_max_pd(_mm256_div_pd(_mm256_sub_pd(xv, s0), h), zero), top);
+        const __m128i i = _mm256_cvttpd_epi32(q);
+        // Masked gathers with an explicit source (the unmasked intrinsic
+        // leaves it undefined)
+        const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        const __m256d Si = _mm256_mask_i32gather_pd(zero, S, i, all, 8);
+        const __m256d Sp = _mm256_mask_i32gather_pd(zero, S + 1, i, all, 8);
+        const __m256d lt = _mm256_cmp_pd(xv, Si, _CMP_LT_OQ);
+        const __m256d up = _mm256_andnot_pd(lt, _mm256_cmp_pd(xv, Sp, _CMP_GE_OQ));
+        __m256d qi = _mm256_add_pd(_mm256_sub_pd(_mm256_cvtepi32_pd(i), _mm256_and_pd(lt, one)),
+                                   _mm256_and_pd(up, one));
+        qi = _mm256_min_pd(_mm256_max_pd(qi, zero), top);
+        _mm256_storeu_pd(x + m, xv);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(idx + m), _mm256_cvttpd_epi32(qi));
+    }
+    _mm256_zeroupper();
+    bracketTail(S, Ns, dS, spots, x, idx, m, n);
+}
+
+// ---------------- AVX-512 (8 lanes) ----------------
+
+__attribute__((target("avx512f")))
+void stepAVX512(const double* A, const double* B, const double* C,
+                const double* v, double* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(A + i), _mm512_loadu_pd(v + i - 1)),
+                                    _mm512_mul_pd(_mm512_loadu_pd(B + i), _mm512_loadu_pd(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(_mm512_loadu_pd(C + i), _mm512_loadu_pd(v + i + 1)));
+        _mm512_storeu_pd(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepAmericanAVX512(const double* A, const double* B, const double* C,
+                        const double* v, const double* obstacle, double* out,
+                        int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(A + i), _mm512_loadu_pd(v + i - 1)),
+                                    _mm512_mul_pd(_mm512_loadu_pd(B + i), _mm512_loadu_pd(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(_mm512_loadu_pd(C + i), _mm512_loadu_pd(v + i + 1)));
+        _mm512_storeu_pd(out + i, _mm512_max_pd(_mm512_loadu_pd(obstacle + i), val));
+    }
+    _mm256_zeroupper();
+    stepAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepConstAVX512(double a, double b, double c,
+                     const double* v, double* out, int begin, int end)
+{
+    const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b), vc = _mm512_set1_pd(c);
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(va, _mm512_loadu_pd(v + i - 1)),
+                                    _mm512_mul_pd(vb, _mm512_loadu_pd(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(vc, _mm512_loadu_pd(v + i + 1)));
+        _mm512_storeu_pd(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepConstScalar(a, b, c, v, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepConstAmericanAVX512(double a, double b, double c,
+                             const double* v, const double* obstacle, double* out,
+                             int begin, int end)
+{
+    const __m512d va = _mm512_set1_pd(a), vb = _mm512_set1_pd(b), vc = _mm512_set1_pd(c);
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(va, _mm512_loadu_pd(v + i - 1)),
+                                    _mm512_mul_pd(vb, _mm512_loadu_pd(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(vc, _mm512_loadu_pd(v + i + 1)));
+        _mm512_storeu_pd(out + i, _mm512_max_pd(_mm512_loadu_pd(obstacle + i), val));
+    }
+    _mm256_zeroupper();
+    stepConstAmericanScalar(a, b, c, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepLanesAVX512(const double* g, const double* s, const double* m, const double* b0,
+                     const double* v, double* out, int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 8 <= lanes; k += 8) {
+        const __m512d ls = _mm512_loadu_pd(s + k), lm = _mm512_loadu_pd(m + k), lb = _mm512_loadu_pd(b0 + k);
+        __m512d vl = _mm512_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m512d vc = _mm512_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m512d vr = _mm512_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m512d A = _mm512_add_pd(_mm512_mul_pd(ls, _mm512_set1_pd(gi[0])),
+                                            _mm512_mul_pd(lm, _mm512_set1_pd(gi[1])));
+            const __m512d C = _mm512_add_pd(_mm512_mul_pd(ls, _mm512_set1_pd(gi[2])),
+                                            _mm512_mul_pd(lm, _mm512_set1_pd(gi[3])));
+            const __m512d B = _mm512_sub_pd(lb, _mm512_add_pd(A, C));
+            __m512d val = _mm512_add_pd(_mm512_mul_pd(A, vl), _mm512_mul_pd(B, vc));
+            val = _mm512_add_pd(val, _mm512_mul_pd(C, vr));
+            _mm512_storeu_pd(out + static_cast<long>(i) * lanes + k, val);
+            vl = vc;
+            vc = vr;
+        }
+    }
+    _mm256_zeroupper();
+    stepLanesTail(g, s, m, b0, v, nullptr, out, lanes, k, begin, end);
+}
+
+__attribute__((target("avx512f")))
+void stepLanesAmericanAVX512(const double* g, const double* s, const double* m, const double* b0,
+                             const double* v, const double* obstacle, double* out,
+                             int lanes, int begin, int end)
+{
+    int k = 0;
+    for (; k + 8 <= lanes; k += 8) {
+        const __m512d ls = _mm512_loadu_pd(s + k), lm = _mm512_loadu_pd(m + k), lb = _mm512_loadu_pd(b0 + k);
+        __m512d vl = _mm512_loadu_pd(v + static_cast<long>(begin - 1) * lanes + k);
+        __m512d vc = _mm512_loadu_pd(v + static_cast<long>(begin) * lanes + k);
+        for (int i = begin; i < end; ++i) {
+            const double* gi = g + 4 * i;
+            const __m512d vr = _mm512_loadu_pd(v + static_cast<long>(i + 1) * lanes + k);
+            const __m512d A = _mm512_add_pd(_mm512_mul_pd(ls, _mm512_set1_pd(gi[0])),
+                                            _mm512_mul_pd(lm, _mm512_set1_pd(gi[1])));
+            const __m512d C = _mm512_add_pd(_mm512_mul_pd(ls, _mm512_set1_pd(gi[2])),
+                                            _mm512_mul_pd(lm, _mm512_set1_pd(gi[3])));
+            const __m512d B = _mm512_sub_pd(lb, _mm512_add_pd(A, C));
+            __m512d val = _mm512_add_pd(_mm512_mul_pd(A, vl), _mm512_mul_pd(B, vc));
+            val = _mm512_add_pd(val, _mm512_mul_pd(C, vr));
+            _mm512_storeu_pd(out + static_cast<long>(i) * lanes + k, _mm512_max_pd(_mm512_set1_pd(obstacle[i]), val));
+            vl = vc;
+            vc = vr;
+        }
+    }
+    _mm256_zeroupper();
+    stepLanesTail(g, s, m, b0, v, obstacle, out, lanes, k, begin, end);
+}
+
+__attribute__((target("avx512f")))
+inline __m512d loadFloat8(const float* p) { return _mm512_cvtps_pd(_mm256_loadu_ps(p)); }
+
+__attribute__((target("avx512f")))
+inline void storeFloat8(float* p, __m512d x) { _mm256_storeu_ps(p, _mm512_cvtpd_ps(x)); }
+
+__attribute__((target("avx512f")))
+void stepFloatAVX512(const float* A, const float* C, const float* D,
+                     const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 16 <= end; i += 16) {
+        const __m512 vc = _mm512_loadu_ps(v + i);
+        __m512 inc = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(A + i), _mm512_sub_ps(_mm512_loadu_ps(v + i - 1), vc)),
+                                   _mm512_mul_ps(_mm512_loadu_ps(C + i), _mm512_sub_ps(_mm512_loadu_ps(v + i + 1), vc)));
+        inc = _mm512_sub_ps(inc, _mm512_mul_ps(_mm512_loadu_ps(D + i), vc));
+        _mm512_storeu_ps(out + i, _mm512_add_ps(vc, inc));
+    }
+    _mm256_zeroupper();
+    stepFloatScalar(A, C, D, v, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepFloatAmericanAVX512(const float* A, const float* C, const float* D,
+                             const float* v, const float* obstacle, float* out,
+                             int begin, int end)
+{
+    int i = begin;
+    for (; i + 16 <= end; i += 16) {
+        const __m512 vc = _mm512_loadu_ps(v + i);
+        __m512 inc = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(A + i), _mm512_sub_ps(_mm512_loadu_ps(v + i - 1), vc)),
+                                   _mm512_mul_ps(_mm512_loadu_ps(C + i), _mm512_sub_ps(_mm512_loadu_ps(v + i + 1), vc)));
+        inc = _mm512_sub_ps(inc, _mm512_mul_ps(_mm512_loadu_ps(D + i), vc));
+        _mm512_storeu_ps(out + i, _mm512_max_ps(_mm512_loadu_ps(obstacle + i), _mm512_add_ps(vc, inc)));
+    }
+    _mm256_zeroupper();
+    stepFloatAmericanScalar(A, C, D, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepMixedAVX512(const double* A, const double* B, const double* C,
+                     const float* v, float* out, int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(A + i), loadFloat8(v + i - 1)),
+                                    _mm512_mul_pd(_mm512_loadu_pd(B + i), loadFloat8(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(_mm512_loadu_pd(C + i), loadFloat8(v + i + 1)));
+        storeFloat8(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepMixedScalar(A, B, C, v, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void stepMixedAmericanAVX512(const double* A, const double* B, const double* C,
+                             const float* v, const double* obstacle, float* out,
+                             int begin, int end)
+{
+    int i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d val = _mm512_add_pd(_mm512_mul_pd(_mm512_loadu_pd(A + i), loadFloat8(v + i - 1)),
+                                    _mm512_mul_pd(_mm512_loadu_pd(B + i), loadFloat8(v + i)));
+        val = _mm512_add_pd(val, _mm512_mul_pd(_mm512_loadu_pd(C + i), loadFloat8(v + i + 1)));
+        val = _mm512_max_pd(_mm512_loadu_pd(obstacle + i), val);
+        storeFloat8(out + i, val);
+    }
+    _mm256_zeroupper();
+    stepMixedAmericanScalar(A, B, C, v, obstacle, out, i, end);
+}
+
+__attribute__((target("avx512f")))
+void bracketAVX512(const double* S, int Ns, double dS,
+                   const double* spots, double* x, int* idx, int n)
+{
+    const __m512d s0 = _mm512_set1_pd(S[0]), sN = _mm512_set1_pd(S[Ns]);
+    const __m512d lo = _mm512_set1_pd(S[0] + 1e-12), hi = _mm512_set1_pd(S[Ns] - 1e-12);
+    const __m512d h = _mm512_set1_pd(dS), zero = _mm512_setzero_pd();
+    const __m512d top = _mm512_set1_pd(Ns - 1), one = _mm512_set1_pd(1.0);
+    int m = 0;
+    for (; m + 8 <= n; m += 8) {
+        const __m512d sm = _mm512_loadu_pd(spots + m);
+        __m512d xv = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(sm, sN, _CMP_GE_OQ), sm, hi);
+        xv = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(sm, s0, _CMP_LE_OQ), xv, lo);
+        const __m512d q = _mm512_min_pd(_mm512_max_pd(_mm512_div_pd(_mm512_sub_pd(xv, s0), h), zero), top);
+        const __m256i i = _mm512_cvttpd_epi32(q);
+        const __m512d Si = _mm512_mask_i32gather_pd(zero, 0xFF, i, S, 8);
+        const __m512d Sp = _mm512_mask_i32gather_pd(zero, 0xFF, i, S + 1, 8);
+        const __mmask8 lt = _mm512_cmp_pd_mask(xv, Si, _CMP_LT_OQ);
+        const __mmask8 up = static_cast<__mmask8>(~lt & _mm512_cmp_pd_mask(xv, Sp, _CMP_GE_OQ));
+        __m512d qi = _mm512_cvtepi32_pd(i);
+        qi = _mm512_mask_add_pd(_mm512_mask_sub_pd(qi, lt, qi, one), up, qi, one);
+        qi = _mm512_min_pd(_mm512_max_pd(qi, zero), top);
+        _mm512_storeu_pd(x + m, xv);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(idx + m), _mm512_cvttpd_epi32(qi));
+    }
+    _mm256_zeroupper();
+    bracketTail(S, Ns, dS, spots, x, idx, m, n);
+}
+
+#endif // BS_STENCIL_X86
+
+const Kernels kTable[] = {
+    { SimdLevel::Scalar, &stepScalar, &stepAmericanScalar, &stepConstScalar, &stepConstAmericanScalar,
+      &stepLanesScalar, &stepLanesAmericanScalar,
+      &stepFloatScalar, &stepFloatAmericanScalar, &stepMixedScalar, &stepMixedAmericanScalar,
+      &bracketScalar },
+#ifdef BS_STENCIL_X86
+    { SimdLevel::SSE2,   &stepSSE2,   &stepAmericanSSE2,   &stepConstSSE2,   &stepConstAmericanSSE2,
+      &stepLanesSSE2,   &stepLanesAmericanSSE2,
+      &stepFloatSSE2,   &stepFloatAmericanSSE2,   &stepMixedSSE2,   &stepMixedAmericanSSE2,
+      &bracketSSE2 },
+    { SimdLevel::AVX2,   &stepAVX2,   &stepAmericanAVX2,   &stepConstAVX2,   &stepConstAmericanAVX2,
+      &stepLanesAVX2,   &stepLanesAmericanAVX2,
+      &stepFloatAVX2,   &stepFloatAmericanAVX2,   &stepMixedAVX2,   &stepMixedAmericanAVX2,
+      &bracketAVX2 },
+    { SimdLevel::AVX512, &stepAVX512, &stepAmericanAVX512, &stepConstAVX512, &stepConstAmericanAVX512,
+      &stepLanesAVX512, &stepLanesAmericanAVX512,
+      &stepFloatAVX512, &stepFloatAmericanAVX512, &stepMixedAVX512, &stepMixedAmericanAVX512,
+      &bracketAVX512 },
+#endif
+};
+
+SimdLevel hardwareLevel()
+{
+#ifdef BS_STENCIL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2"))    return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))    return SimdLevel::SSE2;
+#endif
+    return SimdLevel::Scalar;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel()
+{
+    SimdLevel level = hardwareLevel();
+
+    if (const char* env = std::getenv("BS_SIMD")) {
+        SimdLevel cap = level;
+        if      (std::strcmp(env, "scalar") == 0) cap = SimdLevel::Scalar;
+        else if (std::strcmp(env, "sse2") == 0)   cap = SimdLevel::SSE2;
+        else if (std::strcmp(env, "avx2") == 0)   cap = SimdLevel::AVX2;
+        else if (std::strcmp(env, "avx512") == 0) cap = SimdLevel::AVX512;
+        level = std::min(level, cap);
+    }
+    return level;
+}
+
+const Kernels& kernels(SimdLevel level)
+{
+    static const SimdLevel supported = hardwareLevel();
+    const int n = static_cast<int>(sizeof(kTable) / sizeof(kTable[0]));
+
+    int idx = std::min(static_cast<int>(std::min(level, supported)), n - 1);
+    return kTable[idx];
+}
+
+const Kernels& bestKernels()
+{
+    static const Kernels& best = kernels(detectSimdLevel());
+    return best;
+}
+
+const char* name(SimdLevel level)
+{
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+FlushDenormals::FlushDenormals()
+{
+#ifdef BS_STENCIL_X86
+    saved_ = _mm_getcsr();
+    _mm_setcsr(saved_ | 0x8040u);   // FTZ (bit 15) | DAZ (bit 6)
+#endif
+}
+
+FlushDenormals::~FlushDenormals()
+{
+#ifdef BS_STENCIL_X86
+    _mm_setcsr(saved_);
+#endif
+}
+
+} // namespace stencil
@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * Three-point stencil kernels of the explicit scheme
+ *
+ *   out[i] = A[i] * v[i-1] + B[i] * v[i] + C[i] * v[i+1],   i in [begin, end)
+ *
+ * with an optional obstacle out[i] = max(out[i], obstacle[i]) (American),
+ * and a constant-coefficient variant out[i] = a v[i-1] + b v[i] + c v[i+1]
+ * (log-price grid, LogFdSolver) that streams v only.
+ * Lane variants step `lanes` value vectors stored node-major (lane k of node
+ * i at i*lanes + k, ScenarioPricer), generating the coefficients of each
+ * (node, lane) from four node constants g[4i..4i+3] = (a2, a1, c2, c1)
+ * shared by all lanes and three lane constants (s, m, b0):
+ *   A = s a2 + m a1,   C = s c2 + m c1,   B = b0 - (A + C)
+ * (three-point derivative weights sum to zero), so that only the values
+ * and one obstacle per node are streamed.
+ * Reduced-precision variants (ExplicitFdSolver::Precision) store the values
+ * as float. Float kernels compute in float, in increment form
+ *   out[i] = v[i] + ((A[i] (v[i-1] - v[i]) + C[i] (v[i+1] - v[i])) - D[i] v[i])
+ * with D = 1 - (A + B + C) (= r dt), so that float rounding of the
+ * coefficients only perturbs the small increment, not the value carried
+ * over each step; mixed kernels keep double coefficients and arithmetic
+ * and round the result to float.
+ * The bracket kernel locates spots on a uniform price grid (clamp inside
+ * the grid, direct index, one-node rounding correction) for spot ladders.
+ * One scalar reference kernel plus SSE2 / AVX2 / AVX-512 kernels, selected at
+ * runtime from the CPU features of the host. All kernels evaluate the same
+ * operations in the same order (no FMA contraction), so their results are
+ * bitwise identical to the scalar reference.
+ */
+namespace stencil {
+
+enum class SimdLevel { Scalar = 0, SSE2 = 1, AVX2 = 2, AVX512 = 3 };
+
+using StepFn = void (*)(const double* A, const double* B, const double* C,
+                        const double* v, double* out, int begin, int end);
+
+using ObstacleStepFn = void (*)(const double* A, const double* B, const double* C,
+                                const double* v, const double* obstacle, double* out,
+                                int begin, int end);
+
+using ConstStepFn = void (*)(double a, double b, double c,
+                             const double* v, double* out, int begin, int end);
+
+using ConstObstacleStepFn = void (*)(double a, double b, double c,
+                                     const double* v, const double* obstacle, double* out,
+                                     int begin, int end);
+
+using LaneStepFn = void (*)(const double* g, const double* s, const double* m, const double* b0,
+                            const double* v, double* out, int lanes, int begin, int end);
+
+using LaneObstacleStepFn = void (*)(const double* g, const double* s, const double* m, const double* b0,
+                                    const double* v, const double* obstacle, double* out,
+                                    int lanes, int begin, int end);
+
+using FloatStepFn = void (*)(const float* A, const float* C, const float* D,
+                             const float* v, float* out, int begin, int end);
+
+using FloatObstacleStepFn = void (*)(const float* A, const float* C, const float* D,
+                                     const float* v, const float* obstacle, float* out,
+                                     int begin, int end);
+
+using MixedStepFn = void (*)(const double* A, const double* B, const double* C,
+                             const float* v, float* out, int begin, int end);
+
+using MixedObstacleStepFn = void (*)(const double* A, const double* B, const double* C,
+                                     const float* v, const double* obstacle, float* out,
+                                     int begin, int end);
+
+using BracketFn = void (*)(const double* S, int Ns, double dS,
+                           const double* spots, double* x, int* idx, int n);
+
+struct Kernels {
+    SimdLevel level;
+    StepFn step;                 // European step
+    ObstacleStepFn stepAmerican; // step followed by max(., obstacle)
+    ConstStepFn stepConst;                 // same with scalar coefficients
+    ConstObstacleStepFn stepConstAmerican;
+    LaneStepFn stepLanes;                  // node-major lanes, generated coefficients
+    LaneObstacleStepFn stepLanesAmerican;
+    FloatStepFn stepFloat;                 // float values and coefficients, increment form
+    FloatObstacleStepFn stepFloatAmerican;
+    MixedStepFn stepMixed;                 // float values, double arithmetic
+    MixedObstacleStepFn stepMixedAmerican;
+    BracketFn bracket;                     // clamped spots and bracketing nodes, uniform grid
+};
+
+// Best level supported by this CPU (and OS), capped by the BS_SIMD
+// environment variable if set ("scalar", "sse2", "avx2", "avx512")
+SimdLevel detectSimdLevel();
+
+// Kernels for a given level; levels not supported by the host (or not
+// compiled in) fall back to the best supported one below it
+const Kernels& kernels(SimdLevel level);
+
+// Kernels for detectSimdLevel(), resolved once per process
+const Kernels& bestKernels();
+
+const char* name(SimdLevel level);
+
+// Flushes denormal inputs and results to zero (x86 DAZ and FTZ) on the
+// calling thread while in scope; no-op elsewhere. The float sweeps run
+// under it: values decaying below FLT_MIN far out of the money would
+// otherwise take the microcoded denormal path at every step.
+class FlushDenormals {
+public:
+    FlushDenormals();
+    ~FlushDenormals();
+
+    FlushDenormals(const FlushDenormals&) = delete;
+    FlushDenormals& operator=(const FlushDenormals&) = delete;
+
+private:
+    unsigned saved_ = 0;
+};
+
+} // namespace stencil
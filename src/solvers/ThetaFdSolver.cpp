@@ -0,0 +1,208 @@
+#include "ThetaFdSolver.hpp"
+#include "SolverWorkspace.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// LU factors of the tridiagonal matrix (I - theta*dt*L) on interior nodes,
+// computed once per step size and reused by every Thomas sweep
+struct TridiagFactors {
+    double* sub;    // sub-diagonal l_i
+    double* invDen; // 1 / modified diagonal
+    double* sup;    // modified super-diagonal c'_i
+};
+
+// Operator L V = a V[i-1] + b V[i] + c V[i+1] (per unit of time)
+struct Operator {
+    const double* a;
+    const double* b;
+    const double* c;
+};
+
+void factorize(const Operator& L, double theta, double dt, int Ns, TridiagFactors& f)
+{
+    std::fill(f.sub, f.sub + Ns + 1, 0.0);
+    std::fill(f.invDen, f.invDen + Ns + 1, 0.0);
+    std::fill(f.sup, f.sup + Ns + 1, 0.0);
+
+    double prevSup = 0.0;
+    for (int i = 1; i < Ns; ++i) {
+        const double l = -theta * dt * L.a[i];
+        const double d = 1.0 - theta * dt * L.b[i];
+        const double u = -theta * dt * L.c[i];
+
+        const double den = d - (i > 1 ? l * prevSup : 0.0);
+        if (den == 0.0) throw std::runtime_error("Singular tridiagonal system in ThetaFdSolver.");
+
+        f.sub[i] = l;
+        f.invDen[i] = 1.0 / den;
+        f.sup[i] = u / den;
+        prevSup = f.sup[i];
+    }
+}
+
+// One theta step from V (time t+dt) to Vnew (time t), with the Dirichlet
+// values of time t and an optional (American) obstacle
+void thetaStep(const Operator& L,
+               const TridiagFactors& f,
+               double theta, double dt,
+               double left, double right,
+               const double* obstacle,
+               int Ns,
+               const double* V,
+               double* Vnew,
+               double* rhs)
+{
+    const double expl = (1.0 - theta) * dt;
+
+    // Boundaries at the new time level
+    Vnew[0]  = left;
+    Vnew[Ns] = right;
+
+    // Right-hand side (I + (1-theta) dt L) V
+    for (int i = 1; i < Ns; ++i) {
+        rhs[i] = V[i] + expl * (L.a[i] * V[i - 1] + L.b[i] * V[i] + L.c[i] * V[i + 1]);
+    }
+    // Known boundary values move to the right-hand side
+    rhs[1]      += theta * dt * L.a[1] * Vnew[0];
+    rhs[Ns - 1] += theta * dt * L.c[Ns - 1] * Vnew[Ns];
+
+    // Thomas: forward elimination then back substitution
+    rhs[1] *= f.invDen[1];
+    for (int i = 2; i < Ns; ++i) {
+        rhs[i] = (rhs[i] - f.sub[i] * rhs[i - 1]) * f.invDen[i];
+    }
+    Vnew[Ns - 1] = rhs[Ns - 1];
+    for (int i = Ns - 2; i >= 1; --i) {
+        Vnew[i] = rhs[i] - f.sup[i] * Vnew[i + 1];
+    }
+
+    if (obstacle) {
+        for (int i = 1; i < Ns; ++i) {
+            Vnew[i] = std::max(Vnew[i], obstacle[i]);
+        }
+    }
+}
+
+} // namespace
+
+ThetaFdSolver::ThetaFdSolver(double theta, int rannacherSteps)
+    : theta_(theta), rannacherSteps_(rannacherSteps)
+{
+    if (theta_ < 0.5 || theta_ > 1.0)
+        throw std::invalid_argument("theta must be in [0.5, 1] for unconditional stability.");
+    if (rannacherSteps_ < 0)
+        throw std::invalid_argument("rannacherSteps must be >= 0.");
+}
+
+ThetaFdSolver::Result ThetaFdSolver::price(const InterfaceProducts& option,
+                                          const BlackScholesModel& model,
+                                          const FdGrid& grid,
+                                          double S0) const
+{
+    return price(option, model, grid, S0, SolverWorkspace::threadLocal());
+}
+
+ThetaFdSolver::Result ThetaFdSolver::price(const InterfaceProducts& option,
+                                          const BlackScholesModel& model,
+                                          const FdGrid& grid,
+                                          double S0,
+                                          SolverWorkspace& ws,
+                                          bool keepV0) const
+{
+    ExplicitFdSolver::validateGrid(grid);
+    ExplicitFdSolver::validateBarrier(option, grid);
+
+    const int Ns = grid.Ns();
+    const int Nt = grid.Nt();
+    const double dS = grid.dS();
+    const double dt = grid.dt();
+
+    const auto& S = grid.priceGrid();
+
+    const double r = model.r();
+    const double q = model.q();
+    const double sigma2 = model.sigma() * model.sigma();
+
+    ws.prepare(Ns + 1, Nt);
+    ws.prepareTridiag(Ns + 1);
+
+    // Spatial operator (time-independent coefficients)
+    double* a = ws.A.data();
+    double* b = ws.B.data();
+    double* c = ws.C.data();
+    a[0] = b[0] = c[0] = 0.0;
+    a[Ns] = b[Ns] = c[Ns] = 0.0;
+    for (int i = 1; i < Ns; ++i) {
+        const double Si = S[i];
+        const double sig2S2 = sigma2 * Si * Si;
+        const double muS    = (r - q) * Si;
+
+        if (grid.uniform()) {
+            a[i] = 0.5 * ( sig2S2 / (dS * dS) - muS / dS );
+            b[i] = -( sig2S2 / (dS * dS) + r );
+            c[i] = 0.5 * ( sig2S2 / (dS * dS) + muS / dS );
+        } else {
+            const FdGrid::Weights d = grid.weights(i);
+            a[i] = 0.5 * sig2S2 * d.d2m + muS * d.d1m;
+            b[i] = 0.5 * sig2S2 * d.d2c + muS * d.d1c - r;
+            c[i] = 0.5 * sig2S2 * d.d2p + muS * d.d1p;
+        }
+    }
+    const Operator L{a, b, c};
+
+    // Factor arrays and right-hand side from the workspace
+    double* t = ws.tridiag.data();
+    const std::size_t n1 = static_cast<std::size_t>(Ns) + 1;
+    TridiagFactors full{t, t + n1, t + 2 * n1};
+    TridiagFactors half{t + 3 * n1, t + 4 * n1, t + 5 * n1};
+    double* rhs = t + 6 * n1;
+
+    const int startSteps = std::min(rannacherSteps_, Nt);
+    factorize(L, theta_, dt, Ns, full);
+    if (startSteps > 0) factorize(L, 1.0, 0.5 * dt, Ns, half);
+
+    // Dirichlet values and obstacle, evaluated once before the rollback
+    double* left = ws.left.data();
+    double* right = ws.right.data();
+    for (int n = 0; n < Nt; ++n) {
+        left[n]  = option.leftBoundary(grid.time(n));
+        right[n] = option.rightBoundary(grid.time(n), S.back());
+    }
+
+    const double* obstacle = nullptr;
+    if (option.isAmerican()) {
+        double* exercise = ws.obstacle.data();
+        for (int i = 0; i <= Ns; ++i) exercise[i] = option.earlyExerciseValue(S[i]);
+        obstacle = exercise;
+    }
+
+    // Terminal condition: V(T,S)=payoff(S)
+    double* V = ws.V.data();
+    double* Vnew = ws.Vnew.data();
+    for (int i = 0; i <= Ns; ++i) {
+        V[i] = option.payoff(S[i]);
+    }
+
+    // Backward time stepping
+    for (int n = Nt - 1; n >= 0; --n) {
+        if (Nt - 1 - n < startSteps) {
+            // Rannacher start-up: two implicit half-steps
+            const double tMid = grid.time(n) + 0.5 * dt;
+            thetaStep(L, half, 1.0, 0.5 * dt, option.leftBoundary(tMid), option.rightBoundary(tMid, S.back()),
+                      obstacle, Ns, V, Vnew, rhs);
+            std::swap(V, Vnew);
+            thetaStep(L, half, 1.0, 0.5 * dt, left[n], right[n], obstacle, Ns, V, Vnew, rhs);
+        } else {
+            thetaStep(L, full, theta_, dt, left[n], right[n], obstacle, Ns, V, Vnew, rhs);
+        }
+        std::swap(V, Vnew);
+    }
+
+    ws.setValues(V, Ns + 1);
+    return ExplicitFdSolver::makeResult(grid, V, S0, keepV0);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <vector>
+#include "ExplicitFdSolver.hpp"
+#include "../grid/FdGrid.hpp"
+#include "../model/BlackScholesModel.hpp"
+#include "../products/InterfaceProducts.hpp"
+
+class SolverWorkspace;
+
+/**
+ * Theta-scheme finite-difference solver for the Black–Scholes PDE
+ * theta = 1   : fully implicit (backward Euler)
+ * theta = 0.5 : Crank–Nicolson
+ *
+ * Unconditionally stable: Nt can be chosen from accuracy rather than from
+ * the explicit stability bound (see GridParameters::makeImplicitGrid).
+ * Each time step solves a tridiagonal system with the Thomas algorithm.
+ * The first rannacherSteps steps are replaced by two fully implicit
+ * half-steps each (Rannacher start-up) to damp the payoff kink.
+ * American exercise is applied by projection after each step.
+ */
+class ThetaFdSolver {
+public:
+    using Result = ExplicitFdSolver::Result;
+
+    explicit ThetaFdSolver(double theta = 0.5, int rannacherSteps = 2);
+
+    // Buffers come from the calling thread's SolverWorkspace
+    Result price(const InterfaceProducts& option,
+                 const BlackScholesModel& model,
+                 const FdGrid& grid,
+                 double S0) const;
+
+    // Same with an explicit workspace (see ExplicitFdSolver::price): no
+    // allocation once warm, e.g. across the iterations of an implied-vol search
+    Result price(const InterfaceProducts& option,
+                 const BlackScholesModel& model,
+                 const FdGrid& grid,
+                 double S0,
+                 SolverWorkspace& ws,
+                 bool keepV0 = true) const;
+
+    double theta() const       { return theta_; }
+    int rannacherSteps() const { return rannacherSteps_; }
+
+private:
+    double theta_;
+    int rannacherSteps_;
+};
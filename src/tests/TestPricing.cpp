@@ -1,11 +1,32 @@
 #include <iostream>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
+#include <sstream>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
 #include "model/BlackScholesModel.hpp"
 #include "grid/FdGrid.hpp"
 #include "grid/GridParameters.hpp"
+#include "grid/TermStructureGrid.hpp"
+#include "model/TermStructureModel.hpp"
 #include "solvers/ExplicitFdSolver.hpp"
+#include "solvers/ThetaFdSolver.hpp"
+#include "solvers/LogFdSolver.hpp"
+#include "solvers/SolverWorkspace.hpp"
+#include "solvers/AnalyticBsPricer.hpp"
+#include "solvers/PricingEngine.hpp"
+#include "solvers/PricingCache.hpp"
+#include "solvers/AdaptivePricer.hpp"
+#include "solvers/ImpliedVolSolver.hpp"
+#include "solvers/ScenarioPricer.hpp"
+#include "solvers/AdiFdSolver.hpp"
+#include "batch/BatchPricer.hpp"
+#include "batch/TradeRecords.hpp"
+#include "parallel/ThreadPool.hpp"
 #include "products/EuropeanCall.hpp"
 #include "products/EuropeanPut.hpp"
 #include "products/AmericanCall.hpp"
@@ -14,6 +35,27 @@
 #include "products/BullCallSpread.hpp"
 #include "products/BearPutSpread.hpp"
 #include "products/Straddle.hpp"
+#include "products/BarrierOption.hpp"
+#include "products/BasketOption.hpp"
+#include "products/SpreadOption.hpp"
+#include "products/MaxOption.hpp"
+
+// User-defined product (not final): priced through the generic virtual path
+class UserAmericanPut : public InterfaceProducts {
+public:
+    UserAmericanPut(double strike, double maturity) : K_(strike), T_(maturity) {}
+
+    double maturity() const override { return T_; }
+    double strike() const override { return K_; }
+    double payoff(double S) const override { return std::max(K_ - S, 0.0); }
+    double leftBoundary(double /*t*/) const override { return K_; }
+    double rightBoundary(double /*t*/, double /*Smax*/) const override { return 0.0; }
+    bool isAmerican() const override { return true; }
+
+private:
+    double K_;
+    double T_;
+};
 
 static bool approx(double a, double b, double tol) {
     return std::fabs(a - b) <= tol;
@@ -89,10 +131,692 @@ int main() {
     // 7) Put/Call gamma equality (European)
     check(approx(C.gamma, P.gamma, 5e-3), "European Call gamma == Put gamma");
 
+    // 8) Crank–Nicolson / implicit on an accuracy-sized grid
+    ThetaFdSolver cn(0.5);
+    ThetaFdSolver implicit(1.0, 0);
+    FdGrid cnGrid = GridParameters::makeImplicitGrid(euroCall, model, S0, 0.002);
+
+    auto Ccn  = cn.price(euroCall, model, cnGrid, S0);
+    auto Pcn  = cn.price(euroPut,  model, cnGrid, S0);
+    auto APcn = cn.price(amerPut,  model, cnGrid, S0);
+    auto Cimp = implicit.price(euroCall, model, cnGrid, S0);
+
+    check(cnGrid.Nt() * 100 < grid.Nt(), "Implicit grid needs far fewer time steps");
+    check(approx(Ccn.price, C.price, 1e-3), "Crank-Nicolson call ~ explicit call");
+    check(approx(Ccn.price - Pcn.price, rhs, tol_price), "Crank-Nicolson put-call parity");
+    check(approx(Ccn.gamma, C.gamma, 1e-4), "Crank-Nicolson gamma ~ explicit gamma");
+    check(approx(APcn.price, AP.price, tol_price), "Crank-Nicolson American put ~ explicit");
+    check(approx(Cimp.price, C.price, 5e-2), "Implicit call ~ explicit call (first order in time)");
+
+    // 9) Batch rollback on one shared grid == one solve per product
+    FdGrid coarse = GridParameters::makeGrid(euroCall, model, S0, 0.01);
+    const std::vector<const InterfaceProducts*> book = {
+        &euroCall, &euroPut, &amerCall, &amerPut, &future, &bull, &bear, &straddle
+    };
+    const auto batch = solver.priceBatch(book, model, coarse, S0);
+
+    bool batchMatches = batch.size() == book.size();
+    for (std::size_t k = 0; batchMatches && k < book.size(); ++k) {
+        const auto single = solver.price(*book[k], model, coarse, S0);
+        batchMatches = approx(batch[k].price, single.price, 1e-12)
+                    && approx(batch[k].delta, single.delta, 1e-12)
+                    && approx(batch[k].gamma, single.gamma, 1e-12);
+    }
+    check(batchMatches, "Batch pricing == single pricing (8 products, shared grid)");
+
+    // 10) Devirtualized kernel == generic virtual path
+    UserAmericanPut userPut(K, T);
+    auto APtyped   = solver.priceProduct(amerPut, model, coarse, S0);
+    auto APgeneric = solver.price(userPut, model, coarse, S0);
+    check(approx(APtyped.price, APgeneric.price, 1e-12) && approx(APtyped.gamma, APgeneric.gamma, 1e-12),
+          "Typed American kernel == generic virtual path");
+
+    // 11) SIMD stencil kernels are bitwise identical to the scalar reference
+    ExplicitFdSolver scalarSolver(stencil::SimdLevel::Scalar);
+    auto APscalar = scalarSolver.price(amerPut,  model, coarse, S0);
+    auto Cscalar  = scalarSolver.price(euroCall, model, coarse, S0);
+    auto Csimd    = solver.price(euroCall, model, coarse, S0);
+    check(APscalar.V0 == APtyped.V0 && Cscalar.V0 == Csimd.V0,
+          std::string("SIMD kernel (") + stencil::name(solver.simdLevel()) + ") == scalar reference");
+
+    // 12) Thread-pool solver == serial solver (bitwise)
+    ThreadPool pool(4);
+    ExplicitFdSolver parallelSolver;
+    parallelSolver.setThreadPool(&pool, 1);
+    auto APpar = parallelSolver.price(amerPut,  model, coarse, S0);
+    auto Cpar  = parallelSolver.price(euroCall, model, coarse, S0);
+    auto Upar  = parallelSolver.price(userPut,  model, coarse, S0);
+    check(APpar.V0 == APtyped.V0 && Cpar.V0 == Csimd.V0 && Upar.V0 == APgeneric.V0,
+          "Parallel solver (4 threads) == serial solver");
+
+    // 13) Temporal blocking == plain sweep (bitwise, incl. boundaries and obstacle)
+    ExplicitFdSolver tiledSolver;
+    tiledSolver.setTemporalBlocking(7, 50);
+    auto APtiled = tiledSolver.price(amerPut,  model, coarse, S0);
+    auto Ctiled  = tiledSolver.price(euroCall, model, coarse, S0);
+    auto Utiled  = tiledSolver.price(userPut,  model, coarse, S0);
+    check(APtiled.V0 == APtyped.V0 && Ctiled.V0 == Csimd.V0 && Utiled.V0 == APgeneric.V0,
+          "Temporal blocking (7 steps, 50-node tiles) == plain sweep");
+
+    // 14) Closed-form engine vs PDE, and automatic routing
+    double worstCdf = 0.0;
+    for (double x = -8.0; x <= 8.0; x += 0.01)
+        worstCdf = std::max(worstCdf, std::fabs(normal::cdf(x) - 0.5 * std::erfc(-x / std::sqrt(2.0))));
+    check(worstCdf < 1e-14, "Vectorized normal CDF ~ erfc");
+
+    AnalyticBsPricer analytic;
+    const auto closed = analytic.priceBatch({&euroCall, &euroPut, &future, &bull, &bear, &straddle}, model, S0);
+    const ExplicitFdSolver::Result* pde[] = {&C, &P, &F, &Bull, &Bear, &Str};
+    bool analyticMatches = true;
+    for (int k = 0; k < 6; ++k) {
+        analyticMatches = analyticMatches
+            && approx(closed[k].price, pde[k]->price, 1e-3)
+            && approx(closed[k].delta, pde[k]->delta, 1e-3)
+            && approx(closed[k].gamma, pde[k]->gamma, 1e-4);
+    }
+    check(analyticMatches, "Closed form ~ PDE (price, delta, gamma) for 6 European products");
+    check(approx(closed[0].price - closed[1].price, rhs, 1e-12), "Closed-form put-call parity (exact)");
+    check(!AnalyticBsPricer::supports(amerPut) && !AnalyticBsPricer::supports(userPut),
+          "No closed form for American / user-defined products");
+
+    PricingEngine::Config fastCfg;
+    fastCfg.rel_dS = 0.01;
+    PricingEngine engine(fastCfg);
+    const auto routed = engine.priceBatch({&euroCall, &amerPut, &straddle, &amerCall}, model, S0);
+    check(routed[0].method == PricingEngine::Method::Analytic && routed[1].method == PricingEngine::Method::Pde
+          && routed[2].method == PricingEngine::Method::Analytic && routed[3].method == PricingEngine::Method::Pde,
+          "Engine routes European products to closed form, American to PDE");
+    check(approx(routed[0].result.price, closed[0].price, 1e-14) && approx(routed[1].result.price, APtyped.price, 1e-12),
+          "Engine batch results in input order");
+
+    // 15) Spot ladder from one rollback == one solve per spot
+    std::vector<double> spots;
+    for (int k = -20; k <= 20; ++k) spots.push_back(S0 * (1.0 + 0.01 * k));
+    const auto lad = solver.priceLadder(amerPut, model, coarse, spots);
+
+    bool ladderMatches = lad.price.size() == spots.size();
+    for (std::size_t k = 0; ladderMatches && k < spots.size(); ++k) {
+        const double S = spots[k];
+        const auto& grd = coarse.priceGrid();
+        int i = static_cast<int>(std::upper_bound(grd.begin(), grd.end(), S) - grd.begin()) - 1;
+        i = std::min(std::max(i, 1), coarse.Ns() - 1);
+        const double dS = coarse.dS();
+        const auto& V = APtyped.V0;
+
+        ladderMatches = lad.price[k] == coarse.interpolate(V, S)
+                     && lad.delta[k] == (V[i + 1] - V[i - 1]) / (2.0 * dS)
+                     && lad.gamma[k] == (V[i + 1] - 2.0 * V[i] + V[i - 1]) / (dS * dS);
+    }
+    check(ladderMatches, "Spot ladder (41 points, one solve) == per-spot results");
+
+    // Spots at and above Smax on a large-magnitude grid: the clamp rounds
+    // back onto S.back(), the bracket must stay on the last interval
+    const FdGrid wide(1.0, 40000.0, 50000, 1000);
+    EuropeanCall wideCall(30000.0, 1.0, model);
+    const auto wideRes = solver.price(wideCall, model, wide, 40000.0);
+    std::vector<double> edgeSpots{39990.0, 39999.0, 40000.0, 50000.0, 0.0, -1.0, 20000.0, 40000.0, 1e6};
+    const auto wideLad = ExplicitFdSolver::ladder(wide, wideRes.V0, edgeSpots);
+    bool edgeMatches = wideRes.price == wideRes.V0.back();
+    for (std::size_t k = 0; k < edgeSpots.size(); ++k) {
+        const double x = std::min(std::max(edgeSpots[k], 0.0), 40000.0);
+        edgeMatches = edgeMatches && approx(wideLad.price[k], wide.interpolate(wideRes.V0, x), 1e-9)
+                   && std::isfinite(wideLad.delta[k]) && std::isfinite(wideLad.gamma[k]);
+    }
+    for (stencil::SimdLevel level : {stencil::SimdLevel::Scalar, stencil::SimdLevel::SSE2,
+                                     stencil::SimdLevel::AVX2, stencil::SimdLevel::AVX512}) {
+        std::vector<double> xs(edgeSpots.size()), xr(edgeSpots.size());
+        std::vector<int> is(edgeSpots.size()), ir(edgeSpots.size());
+        const int n = static_cast<int>(edgeSpots.size());
+        stencil::kernels(stencil::SimdLevel::Scalar).bracket(wide.priceGrid().data(), wide.Ns(), wide.dS(),
+                                                             edgeSpots.data(), xs.data(), is.data(), n);
+        stencil::kernels(level).bracket(wide.priceGrid().data(), wide.Ns(), wide.dS(),
+                                        edgeSpots.data(), xr.data(), ir.data(), n);
+        edgeMatches = edgeMatches && xs == xr && is == ir && is[2] == wide.Ns() - 1 && is[3] == wide.Ns() - 1;
+    }
+    check(edgeMatches, "Spot at/above Smax on a large grid: last interval, SIMD bracket == scalar");
+
+    // 16) Reusable workspace: no V0 copy, no reallocation once warm
+    SolverWorkspace ws;
+    auto APws = solver.price(amerPut, model, coarse, S0, ws, false);
+    const double* firstBuffer = ws.V.data();
+    const std::size_t warmBytes = ws.capacityBytes();
+    auto Cws = solver.price(euroCall, model, coarse, S0, ws, false);
+    check(APws.V0.empty() && approx(APws.price, APtyped.price, 1e-15) && approx(Cws.price, Csimd.price, 1e-15),
+          "Workspace solve without V0 copy gives the same prices");
+    check(ws.valueCount() == coarse.Ns() + 1 && std::equal(Csimd.V0.begin(), Csimd.V0.end(), ws.values()),
+          "Workspace exposes V0 as a view");
+    check(ws.V.data() == firstBuffer && ws.capacityBytes() == warmBytes, "Warm workspace is reused as is");
+
+    // 17) Strike-clustered (non-uniform) grids
+    const FdGrid sameNodes(cnGrid.T(), cnGrid.Nt(), cnGrid.priceGrid());
+    check(!sameNodes.uniform() && approx(cn.price(amerPut, model, sameNodes, S0).price, APcn.price, 1e-10),
+          "Variable-spacing stencil on uniform nodes ~ uniform stencil (rounding)");
+
+    BlackScholesModel volModel(r, 0.40, q);
+    EuropeanPut longPut(110.0, 5.0, volModel);
+    const double longRef = analytic.price(longPut, volModel, S0).price;
+    FdGrid longUniform   = GridParameters::makeImplicitGrid(longPut, volModel, S0, 0.005);
+    FdGrid longClustered = GridParameters::makeClusteredImplicitGrid(longPut, volModel, S0, 0.005);
+    check(longClustered.Ns() * 5 < longUniform.Ns()
+          && approx(cn.price(longPut, volModel, longUniform, S0).price, longRef, 5e-4)
+          && approx(cn.price(longPut, volModel, longClustered, S0).price, longRef, 5e-4),
+          "Clustered grid: same accuracy with 5x fewer nodes (T=5, vol 40%)");
+
+    FdGrid spreadGrid = GridParameters::makeClusteredGrid(bull, model, S0, 0.01);
+    const auto& spreadNodes = spreadGrid.priceGrid();
+    check(std::binary_search(spreadNodes.begin(), spreadNodes.end(), K1)
+          && std::binary_search(spreadNodes.begin(), spreadNodes.end(), K2),
+          "Clustered grid has both spread strikes on nodes");
+    const auto BullClustered = solver.price(bull, model, spreadGrid, S0);
+    const auto BullRef = analytic.price(bull, model, S0);
+    check(approx(BullClustered.price, BullRef.price, 1e-3) && approx(BullClustered.delta, BullRef.delta, 1e-3),
+          "Explicit solver on clustered grid ~ closed form (bull spread)");
+
+    // 18) Log-price solver: constant stencil, dt free of Smax
+    LogFdSolver logSolver;
+    LogFdSolver logScalar(stencil::SimdLevel::Scalar);
+    FdGrid logGrid = GridParameters::makeLogGrid(euroCall, model, S0, 0.005);
+    FdGrid sGrid   = GridParameters::makeGrid(euroCall, model, S0, 0.005);
+
+    const auto Clog  = logSolver.price(euroCall, model, logGrid, S0);
+    const auto Plog  = logSolver.price(euroPut,  model, logGrid, S0);
+    const auto APlog = logSolver.price(amerPut,  model, logGrid, S0);
+    const auto APlogScalar = logScalar.price(amerPut, model, logGrid, S0);
+
+    check(logGrid.Nt() * 5 < sGrid.Nt(), "Log grid: 5x fewer explicit time steps at the same rel_dS");
+    check(approx(Clog.price, closed[0].price, 1e-3) && approx(Plog.price, closed[1].price, 1e-3)
+          && approx(Clog.delta, closed[0].delta, 1e-3) && approx(Clog.gamma, closed[0].gamma, 1e-4),
+          "Log-price solver ~ closed form (call, put)");
+    check(approx(APlog.price, APcn.price, tol_price), "Log-price American put ~ Crank-Nicolson");
+    check(APlogScalar.V0 == APlog.V0, "Constant-stencil SIMD kernel == scalar (bitwise)");
+
+    bool rejectsUniform = false;
+    try { logSolver.price(euroCall, model, sGrid, S0); } catch (const std::invalid_argument&) { rejectsUniform = true; }
+    check(rejectsUniform, "Log-price solver rejects a uniform S-grid");
+
+    // 19) Accuracy targeting with Richardson extrapolation
+    AdaptivePricer::Config adaptiveCfg;
+    adaptiveCfg.absTol = 1e-4;
+    AdaptivePricer adaptive(adaptiveCfg);
+    EuropeanPut otmPut(110.0, 0.5, model);
+    const auto targeted = adaptive.price(otmPut, model, S0);
+    const double otmRef = analytic.price(otmPut, model, S0).price;
+    check(targeted.converged && targeted.levels.size() >= 2 && targeted.errorEstimate <= adaptiveCfg.absTol,
+          "Adaptive pricer meets its error estimate");
+    check(approx(targeted.result.price, otmRef, adaptiveCfg.absTol)
+          && std::fabs(targeted.result.price - otmRef) < std::fabs(targeted.levels.back().price - otmRef),
+          "Richardson-extrapolated price within target, closer than the finest level");
+
+    AdaptivePricer::Config looseCfg;
+    looseCfg.absTol = 1e-3;
+    const auto targetedAP = adaptive.price(amerPut, model, S0);
+    const auto looseAP = AdaptivePricer(looseCfg).price(amerPut, model, S0);
+    check(targetedAP.converged && targetedAP.order < 1.5 && approx(looseAP.result.price, targetedAP.result.price, 1e-3)
+          && looseAP.levels.size() < targetedAP.levels.size(),
+          "Adaptive American put: first order detected, looser target stops earlier");
+
+    // 20) Adjoint vega / rho / epsilon / theta from one reverse sweep
+    bool adjointMatches = true;
+    for (const InterfaceProducts* p : {static_cast<const InterfaceProducts*>(&euroCall),
+                                       static_cast<const InterfaceProducts*>(&amerPut)}) {
+        const auto adj = solver.priceAdjoint(*p, model, coarse, S0);
+        const double h = 1e-5;
+        auto bumped = [&](double dr, double ds, double dq) {
+            return solver.price(*p, BlackScholesModel(r + dr, sigma + ds, q + dq), coarse, S0).price;
+        };
+        const double vega = (bumped(0, h, 0) - bumped(0, -h, 0)) / (2 * h);
+        const double rho  = (bumped(h, 0, 0) - bumped(-h, 0, 0)) / (2 * h);
+        const double eps  = (bumped(0, 0, h) - bumped(0, 0, -h)) / (2 * h);
+
+        adjointMatches = adjointMatches
+            && adj.result.price == solver.price(*p, model, coarse, S0).price
+            && approx(adj.vega, vega, 1e-4 * std::fabs(vega))
+            && approx(adj.rho, rho, 1e-4 * std::fabs(rho))
+            && approx(adj.epsilon, eps, 1e-4 * std::fabs(eps));
+    }
+    check(adjointMatches, "Adjoint vega/rho/epsilon == bump-and-revalue (call, American put)");
+
+    const auto adjCall = solver.priceAdjoint(euroCall, model, coarse, S0);
+    const auto adjCallFine = solver.priceAdjoint(euroCall, model, coarse, S0, 1);
+    const auto& cf = closed[0];
+    const double bsVega  = S0 * std::exp(-q * T) * std::sqrt(T) * normal::pdf(
+        (std::log(S0 / K) + (r - q + 0.5 * sigma * sigma) * T) / (sigma * std::sqrt(T)));
+    const double bsTheta = -(0.5 * sigma * sigma * S0 * S0 * cf.gamma + (r - q) * S0 * cf.delta - r * cf.price);
+    check(approx(adjCall.vega, bsVega, 1e-2) && approx(adjCall.theta, bsTheta, 2e-2),
+          "Adjoint vega and theta ~ closed form (call)");
+    check(adjCallFine.vega == adjCall.vega && adjCallFine.checkpoints == coarse.Nt()
+          && adjCall.checkpoints < coarse.Nt() / 10,
+          "Checkpoint interval changes memory, not results");
+
+    // 21) Implied vols of an American put chain (warm-started PDE inversion)
+    const double chainVol = 0.27;
+    const BlackScholesModel chainModel(r, chainVol, q);
+    std::vector<AmericanPut> chainPuts;
+    for (double k : {80.0, 90.0, 100.0, 110.0, 120.0}) chainPuts.emplace_back(k, T, model);
+    std::vector<ImpliedVolSolver::Quote> chain;
+    for (const auto& p : chainPuts) {
+        const FdGrid refGrid = GridParameters::makeClusteredImplicitGrid(p, chainModel, S0, 0.002);
+        chain.push_back({&p, cn.price(p, chainModel, refGrid, S0).price});
+    }
+    ImpliedVolSolver ivSolver;
+    const auto ivSerial = ivSolver.solveChain(chain, model, S0);
+    const auto ivPool = ivSolver.solveChain(chain, model, S0, &pool);
+    bool ivRecovered = true, ivSame = true, ivWarm = true;
+    for (std::size_t k = 0; k < chain.size(); ++k) {
+        ivRecovered = ivRecovered && ivSerial[k].converged && approx(ivSerial[k].vol, chainVol, 2e-3);
+        ivSame = ivSame && ivPool[k].vol == ivSerial[k].vol && ivPool[k].iterations == ivSerial[k].iterations;
+        ivWarm = ivWarm && ivSerial[k].iterations <= 6 && ivSerial[k].warmStart >= ivSerial[k].vol && approx(ivSerial[k].warmStart, chainVol, 0.04);
+    }
+    check(ivRecovered, "Implied vols recover the generating vol (American put chain)");
+    check(ivSame, "Implied-vol chain: thread pool == serial");
+    check(ivWarm, "European warm start above the American vol, <= 6 PDE solves per quote");
+    check(approx(ImpliedVolSolver::europeanImpliedVol(true, closed[0].price, S0, K, T, r, q), sigma, 1e-10)
+          && std::isnan(ImpliedVolSolver::europeanImpliedVol(false, K, S0, K, T, r, q)),
+          "Closed-form European implied vol (and no-solution quote)");
+
+    // 22) Streamed CSV batch: chunked, pooled, input order, per-trade errors
+    std::ostringstream csvIn;
+    csvIn << "type,K1,K2,T,S0,r,sigma,q,rel_dS\n";
+    for (int k = 0; k < 7; ++k) csvIn << "american_put," << 90 + 5 * k << ",,1,100,0.05,0.2,0.02,0.01\n";
+    csvIn << "# comment\n" << "bull_call_spread,120,100,1,100,0.05,0.2,0.02,0.01\n"
+          << "straddle,100,,1,100,0.05,0.2,0.02,0.01\n" << "swaption,100,,1,100,0.05,0.2,0.02,0.01\n";
+    BatchPricer::Config batchCfg;
+    batchCfg.chunkSize = 3;
+    std::istringstream inSerial(csvIn.str()), inPool(csvIn.str());
+    std::ostringstream outSerial, outPool;
+    const auto bSerial = BatchPricer(batchCfg).runCsv(inSerial, outSerial);
+    const auto bPool = BatchPricer(batchCfg, &pool).runCsv(inPool, outPool);
+
+    Trade straddleTrade;
+    BatchPricer::parseCsv("straddle,100,,1,100,0.05,0.2,0.02,0.01", straddleTrade);
+    const auto straddleBatch = BatchPricer().price(straddleTrade, ws);
+    const FdGrid straddleGrid = GridParameters::makeGrid(straddle, model, S0, 0.01);
+    check(bSerial.trades == 10 && bSerial.failed == 2 && bPool.trades == 10
+          && straddleBatch.price == solver.price(straddle, model, straddleGrid, S0).price
+          && straddleBatch.Ns == straddleGrid.Ns(),
+          "Batch CSV: trades counted, bad rows reported, prices == direct solve");
+
+    // Output without the timing column (field 7)
+    auto untimed = [](const std::string& text) {
+        std::istringstream lines(text);
+        std::string row, kept;
+        while (std::getline(lines, row)) {
+            std::size_t start = 0;
+            for (int f = 0; f < 7; ++f) start = row.find(',', start) + 1;
+            kept += row.substr(0, start) + row.substr(row.find(',', start)) + "\n";
+        }
+        return kept;
+    };
+    check(untimed(outPool.str()) == untimed(outSerial.str())
+          && outPool.str().find("\n11,straddle,") != std::string::npos,
+          "Batch CSV: pooled output == serial output, in input order");
+
+    // 23) Binary trade/result records: CSV round trip, mapped pricing == CSV pricing
+    std::string goodCsv;
+    {
+        std::istringstream lines(csvIn.str());
+        std::string row;
+        while (std::getline(lines, row)) {
+            if (row.rfind("swaption", 0) != 0 && row.rfind("bull", 0) != 0) goodCsv += row + "\n";
+        }
+    }
+    const std::string tradesBin = "bs_tests_trades.bin", resultsBin = "bs_tests_results.bin";
+    std::istringstream goodIn(goodCsv);
+    const std::size_t nRecords = TradeRecords::csvToTrades(goodIn, tradesBin);
+    std::ostringstream backToCsv;
+    TradeRecords::tradesToCsv(tradesBin, backToCsv);
+    std::istringstream reparsed(backToCsv.str());
+    const std::size_t nAgain = TradeRecords::csvToTrades(reparsed, "bs_tests_trades2.bin");
+
+    std::ifstream binA(tradesBin, std::ios::binary), binB("bs_tests_trades2.bin", std::ios::binary);
+    const std::string bytesA((std::istreambuf_iterator<char>(binA)), std::istreambuf_iterator<char>());
+    const std::string bytesB((std::istreambuf_iterator<char>(binB)), std::istreambuf_iterator<char>());
+    check(nRecords == 8 && nAgain == 8 && bytesA == bytesB
+          && bytesA.size() == sizeof(RecordFileHeader) + 8 * sizeof(Trade),
+          "Trade records: CSV -> binary -> CSV -> binary is exact");
+
+    const auto binStats = BatchPricer(batchCfg, &pool).runBinary(tradesBin, resultsBin);
+    std::ostringstream resultsCsv;
+    TradeRecords::resultsToCsv(resultsBin, resultsCsv);
+    std::istringstream goodIn2(goodCsv);
+    std::ostringstream goodOut;
+    BatchPricer(batchCfg).runCsv(goodIn2, goodOut);
+    auto priceColumn = [](const std::string& text, int column) {
+        std::istringstream lines(text);
+        std::string row, kept;
+        std::getline(lines, row);
+        while (std::getline(lines, row)) {
+            std::size_t start = 0;
+            for (int f = 0; f < column; ++f) start = row.find(',', start) + 1;
+            kept += row.substr(start, row.find(',', start) - start) + "\n";
+        }
+        return kept;
+    };
+    check(binStats.trades == 8 && binStats.failed == 0
+          && priceColumn(resultsCsv.str(), 1) == priceColumn(goodOut.str(), 2),
+          "Mapped record pricing == CSV pricing");
+
+    bool rejectsResults = false;
+    try { BatchPricer().runBinary(resultsBin, "bs_tests_unused.bin"); } catch (const std::runtime_error&) { rejectsResults = true; }
+    check(rejectsResults && TradeRecords::detect(resultsBin) == TradeRecords::FileKind::Results,
+          "Record files are checked by magic");
+    for (const char* f : {"bs_tests_trades.bin", "bs_tests_trades2.bin", "bs_tests_results.bin", "bs_tests_unused.bin"})
+        std::remove(f);
+
+    // 24) Solver statistics: filled in BS_SOLVER_STATS builds, zero otherwise
+    const auto APstats = solver.price(amerPut, model, coarse, S0);
+    const auto Cstats = solver.price(euroCall, model, coarse, S0);
+    if (solver_stats::kEnabled) {
+        const auto APparStats = parallelSolver.price(amerPut, model, coarse, S0);
+        const auto APtiledStats = tiledSolver.price(amerPut, model, coarse, S0);
+        const auto& st = APstats.stats;
+        check(st.Nt == coarse.Nt() && st.Ns == coarse.Ns()
+              && st.nodeUpdates == static_cast<std::int64_t>(coarse.Ns() - 1) * coarse.Nt()
+              && st.boundaryCalls == 2 * coarse.Nt() && st.payoffCalls == 2 * (coarse.Ns() + 1)
+              && st.rollbackSeconds > 0.0 && st.totalSeconds >= st.rollbackSeconds,
+              "Solve stats: grid counters and phase timings");
+        check(st.exerciseActivations > 0 && Cstats.stats.exerciseActivations == 0
+              && APparStats.stats.exerciseActivations == st.exerciseActivations
+              && APtiledStats.stats.exerciseActivations == st.exerciseActivations,
+              "Solve stats: exercise activations (serial == pooled == tiled)");
+    } else {
+        check(APstats.stats.Nt == 0 && APstats.stats.exerciseActivations == 0
+              && APstats.stats.rollbackSeconds == 0.0 && Cstats.stats.greeksSeconds == 0.0,
+              "Solve stats compiled out (build with BS_SOLVER_STATS to enable)");
+    }
+
+    StatsRegistry registry(2);
+    SolveStats slow, fast, mid;
+    slow.totalSeconds = 3.0; slow.Nt = 300; slow.exerciseActivations = 7;
+    fast.totalSeconds = 1.0; fast.Nt = 100;
+    mid.totalSeconds = 2.0;  mid.Nt = 200;
+    registry.record(fast, "fast");
+    registry.record(slow, "slow");
+    registry.record(mid, "mid");
+    const auto slowestSolves = registry.slowest();
+    check(registry.count() == 3 && approx(registry.sum().totalSeconds, 6.0, 1e-12)
+          && registry.max().Nt == 300 && approx(registry.meanNt(), 200.0, 1e-12)
+          && registry.sum().exerciseActivations == 7 && slowestSolves.size() == 2
+          && slowestSolves[0].tag == "slow" && slowestSolves[1].tag == "mid",
+          "Stats registry: totals, maxima, slowest solves");
+
+    // 25) LRU pricing cache: exact hits, interpolation at a nearby spot, single flight
+    const auto APcoarse = solver.price(amerPut, model, coarse, S0);
+    PricingCache cache(solver);
+    const auto cachedMiss = cache.price(amerPut, model, coarse, S0);
+    const auto cachedHit = cache.price(amerPut, model, coarse, S0);
+    const auto cachedNear = cache.price(amerPut, model, coarse, 101.3, false);
+    const auto directNear = solver.price(amerPut, model, coarse, 101.3);
+    AmericanPut samePut(K, T, model);
+    cache.price(samePut, model, coarse, S0);
+    const BlackScholesModel bumpedVol(r, sigma + 1e-4, q);
+    AmericanPut bumpedPut(K, T, bumpedVol);
+    cache.price(bumpedPut, bumpedVol, coarse, S0);
+    cache.price(userPut, model, coarse, S0);
+    const auto cacheCounters = cache.counters();
+    check(cachedMiss.price == APcoarse.price && cachedHit.price == APcoarse.price && cachedHit.V0 == APcoarse.V0
+          && cachedNear.price == directNear.price && cachedNear.delta == directNear.delta && cachedNear.V0.empty(),
+          "Pricing cache: hits == fresh solve, nearby spot interpolated");
+    check(cacheCounters.hits == 3 && cacheCounters.misses == 3 && cacheCounters.entries == 3,
+          "Pricing cache: key on product type/strikes, model and grid");
+
+    PricingCache tinyCache(solver, 2 * (coarse.Ns() + 1) * sizeof(double) + 1024);
+    tinyCache.price(euroCall, model, coarse, S0);
+    tinyCache.price(euroPut, model, coarse, S0);
+    tinyCache.price(euroCall, model, coarse, S0);
+    tinyCache.price(amerPut, model, coarse, S0);     // evicts the put (least recent)
+    tinyCache.price(euroCall, model, coarse, S0);
+    tinyCache.price(euroPut, model, coarse, S0);
+    const auto tiny = tinyCache.counters();
+    check(tiny.entries == 2 && tiny.evictions == 2 && tiny.hits == 2 && tiny.misses == 4
+          && tiny.bytes <= tinyCache.maxBytes(),
+          "Pricing cache: LRU eviction within the memory budget");
+
+    PricingCache sharedCache(solver);
+    std::vector<double> concurrentPrices(8);
+    pool.parallelFor(8, [&](int k, int) {
+        concurrentPrices[k] = sharedCache.price(amerPut, model, coarse, S0, false).price;
+    });
+    check(sharedCache.counters().misses == 1 && sharedCache.counters().hits == 7
+          && std::all_of(concurrentPrices.begin(), concurrentPrices.end(),
+                         [&](double p) { return p == APcoarse.price; }),
+          "Pricing cache: concurrent requests share one solve");
+
+    // 26) Early-exercise boundary tracking: identical to the full obstacle sweep
+    bool trackedSame = true, boundaryShape = true;
+    ExplicitFdSolver fullObstacle;
+    fullObstacle.setTemporalBlocking(4, 64);   // tiled sweep applies the obstacle everywhere
+    for (double vol : {0.1, 0.3, 0.6}) {
+        for (double rate : {0.0, 0.05, 0.1}) {
+            const BlackScholesModel m(rate, vol, 0.04);
+            AmericanPut put(K, 0.75, m);
+            AmericanCall call(K, 0.75, m);
+            const FdGrid g = GridParameters::makeGrid(put, m, S0, 0.01);
+            for (const InterfaceProducts* p : {static_cast<const InterfaceProducts*>(&put),
+                                               static_cast<const InterfaceProducts*>(&call)}) {
+                const auto tracked = solver.price(*p, m, g, S0);
+                trackedSame = trackedSame && tracked.V0 == fullObstacle.price(*p, m, g, S0).V0
+                              && static_cast<int>(tracked.exerciseBoundary.size()) == g.Nt();
+            }
+            if (rate > 0.0) {
+                const auto b = solver.price(put, m, g, S0).exerciseBoundary;
+                boundaryShape = boundaryShape && b.front() < b.back() && b.back() <= K
+                                && std::all_of(b.begin(), b.end(), [](double x) { return std::isfinite(x); });
+            }
+        }
+    }
+    // High dividends or low volatility: the drift dominates the diffusion on
+    // the first nodes (negative stencil coefficients), the far side is no
+    // longer obstacle-free and the sweep must not skip it
+    for (double vol : {0.02, 0.05, 0.2}) {
+        for (double dividend : {0.08, 0.2}) {
+            const BlackScholesModel m(0.0, vol, dividend);
+            AmericanCall call(K, 0.75, m);
+            const FdGrid g = GridParameters::makeGrid(call, m, S0, 0.02);
+            const auto tracked = solver.price(call, m, g, S0);
+            trackedSame = trackedSame && tracked.V0 == fullObstacle.price(call, m, g, S0).V0;
+            for (int i = 1; i < g.Ns(); ++i)
+                trackedSame = trackedSame && tracked.V0[i] >= call.earlyExerciseValue(g.priceGrid()[i]);
+        }
+    }
+    const BlackScholesModel noDividend(r, sigma, 0.0);
+    AmericanCall noDivCall(K, T, noDividend);
+    const auto noDivBoundary = solver.price(noDivCall, noDividend, coarse, S0).exerciseBoundary;
+    check(trackedSame, "Boundary-tracked American sweep == full obstacle sweep (puts, calls, high-dividend calls)");
+    check(boundaryShape && std::all_of(noDivBoundary.begin(), noDivBoundary.end(),
+                                       [](double x) { return std::isnan(x); }),
+          "Exercise boundary S*(t): put below K and rising to expiry, none for a call without dividends");
+
+    // 27) Scenario engine: every lane ~ a separate solve under its shocked model
+    const auto stress = ScenarioPricer::shocked(model, {-0.05, 0.0, 0.1}, {-0.01, 0.0, 0.02}, {0.0, 0.03});
+    const FdGrid stressGrid = ScenarioPricer::makeGrid(amerPut, stress, S0, 0.01);
+    ScenarioPricer scenarioPricer;                                                  // 3 passes, the last partial
+    ScenarioPricer pooledScenarios(ScenarioPricer::Config{4}, &pool);
+    ScenarioPricer scalarScenarios(ScenarioPricer::Config{5}, nullptr, stencil::SimdLevel::Scalar);
+    const auto stressPut = scenarioPricer.price(ProductType::AmericanPut, K, 0.0, T, stress, stressGrid, S0);
+    const auto stressCall = pooledScenarios.price(ProductType::EuropeanCall, K, 0.0, T, stress, stressGrid, S0);
+    bool scenariosMatch = stressPut.scenarios == 18 && stressCall.scenarios == 18;
+    for (int k = 0; k < 18 && scenariosMatch; ++k) {
+        AmericanPut put(K, T, stress[k]);
+        EuropeanCall call(K, T, stress[k]);
+        const auto p = solver.price(put, stress[k], stressGrid, S0);
+        const auto c = solver.price(call, stress[k], stressGrid, S0);
+        scenariosMatch = approx(stressPut.price(k), p.price, 1e-10) && approx(stressPut.delta(k), p.delta, 1e-10)
+                         && approx(stressPut.gamma(k), p.gamma, 1e-10) && approx(stressCall.price(k), c.price, 1e-10)
+                         && approx(stressCall.delta(k), c.delta, 1e-10) && approx(stressCall.gamma(k), c.gamma, 1e-10);
+    }
+    check(scenariosMatch && stress[17].sigma() == sigma + 0.1 && stress[17].r() == r + 0.02 && stress[17].q() == q + 0.03,
+          "Scenario engine (18 shocks in SIMD lanes, pooled) ~ one solve per shocked model");
+    check(scalarScenarios.price(ProductType::AmericanPut, K, 0.0, T, stress, stressGrid, S0).values == stressPut.values,
+          "Scenario lane kernels: SIMD == scalar (bitwise)");
+
+    // Bucketed: one grid per pass; single-lane passes run on each scenario's own grid
+    const auto bucketed = scenarioPricer.price(ProductType::AmericanPut, K, 0.0, T, stress, S0, 0.01);
+    const auto ownGrids = ScenarioPricer(ScenarioPricer::Config{1}).price(ProductType::AmericanPut, K, 0.0, T, stress, S0, 0.01);
+    bool bucketsMatch = bucketed.scenarios == 18;
+    for (int k = 0; k < 18 && bucketsMatch; ++k) {
+        AmericanPut put(K, T, stress[k]);
+        const auto own = solver.price(put, stress[k], GridParameters::makeGrid(put, stress[k], S0, 0.01), S0);
+        bucketsMatch = approx(ownGrids.price(k), own.price, 1e-10) && approx(ownGrids.delta(k), own.delta, 1e-10)
+                       && approx(bucketed.price(k), own.price, 1e-2) && approx(bucketed.price(k), stressPut.price(k), 1e-2);
+    }
+    check(bucketsMatch, "Scenario engine, bucketed grids: rows in scenario order ~ one solve per model");
+
+    // Knock-outs: the scenario grid ends on the barrier, as the solver's own grids do
+    bool knockOutsMatch = true;
+    for (ProductType type : {ProductType::UpAndOutCall, ProductType::DownAndOutPut}) {
+        const double barrier = type == ProductType::UpAndOutCall ? 130.0 : 80.0;
+        const auto product = ProductFactory::make(type, K, barrier, T, model);
+        const FdGrid koGrid = ScenarioPricer::makeGrid(*product, stress, S0, 0.01);
+        const auto ko = scenarioPricer.price(type, K, barrier, T, stress, koGrid, S0);
+        const auto koBucketed = scenarioPricer.price(type, K, barrier, T, stress, S0, 0.01);
+        for (int k = 0; k < 18 && knockOutsMatch; ++k) {
+            const auto option = ProductFactory::make(type, K, barrier, T, stress[k]);
+            const auto own = solver.price(*option, stress[k], GridParameters::makeGrid(*option, stress[k], S0, 0.01), S0);
+            knockOutsMatch = approx(ko.price(k), solver.price(*option, stress[k], koGrid, S0).price, 1e-10)
+                             && approx(koBucketed.price(k), own.price, 1e-2);
+        }
+    }
+    check(knockOutsMatch, "Scenario engine: up-and-out / down-and-out grids end on the barrier");
+
+    // 28) Term structures: flat curve == constant model, segments stepped exactly
+    const TermStructureModel flatCurve(model);
+    const TermStructureGrid flatGrid = GridParameters::makeGrid(amerPut, flatCurve, S0, 0.01);
+    const FdGrid constGrid = GridParameters::makeGrid(amerPut, model, S0, 0.01);
+    const auto flatPut = solver.price(ProductFactory::builder(ProductType::AmericanPut, K, 0.0, T), flatCurve, flatGrid, S0);
+    const auto constPut = solver.price(amerPut, model, constGrid, S0);
+    check(flatGrid.pieces() == 1 && flatGrid.Nt() == constGrid.Nt() && flatPut.V0 == constPut.V0
+          && flatPut.exerciseBoundary == constPut.exerciseBoundary,
+          "Term structure: flat curve == constant-model solve (bitwise)");
+
+    const TermStructureModel curve({{0.0, 0.01, 0.35, 0.0}, {0.25 * T, 0.03, 0.2, 0.01}, {0.6 * T, 0.06, 0.25, 0.02}});
+    const TermStructureGrid curveGrid = GridParameters::makeGrid(euroCall, curve, S0, 0.01);
+    const BlackScholesModel curveMean = curve.average(0.0, T);
+    EuropeanCall meanCall(K, T, curveMean);
+    const auto curveCall = solver.price(ProductFactory::builder(ProductType::EuropeanCall, K, 0.0, T), curve, curveGrid, S0);
+    int curveSteps = 0;
+    for (int k = 0; k < curveGrid.pieces(); ++k) curveSteps += curveGrid.piece(k).Nt();
+    check(curveGrid.pieces() == 3 && curveGrid.start(1) == 0.25 * T && curveGrid.start(2) == 0.6 * T
+          && curveSteps == curveGrid.Nt() && approx(curveMean.r(), 0.037, 1e-12),
+          "Term-structure grid: time levels on every segment start");
+    check(approx(curveCall.price, analytic.price(meanCall, curveMean, S0).price, 2e-3),
+          "Term structure: European call ~ closed form under the averaged model");
+
+    // 29) Knock-out options: domain ended on the barrier, discrete monitoring on its dates
+    const double H = 90.0;
+    const double lambda = (r - q + 0.5 * sigma * sigma) / (sigma * sigma);
+    const double downOutRef = analytic.price(euroCall, model, S0).price
+                              - std::pow(H / S0, 2.0 * lambda - 2.0) * analytic.price(euroCall, model, H * H / S0).price;
+    BarrierOption downOut(BarrierOption::Type::DownAndOutCall, K, H, T, model);
+    const FdGrid barrierGrid = GridParameters::makeGrid(downOut, model, S0, 0.005);
+    const FdGrid vanillaGrid = GridParameters::makeGrid(euroCall, model, S0, 0.005);
+    const double barrierPrice = solver.price(downOut, model, barrierGrid, S0).price;
+    check(barrierGrid.priceGrid().front() == H && barrierGrid.Ns() < vanillaGrid.Ns()
+          && approx(barrierPrice, downOutRef, 1e-3),
+          "Down-and-out call on a barrier-truncated grid ~ closed form");
+    check(approx(ThetaFdSolver(0.5).price(downOut, model, GridParameters::makeImplicitGrid(downOut, model, S0, 0.005), S0).price,
+                 downOutRef, 2e-3)
+          && approx(LogFdSolver().price(downOut, model, GridParameters::makeLogGrid(downOut, model, S0, 0.005), S0).price,
+                    downOutRef, 1e-3),
+          "Barrier-truncated grids for Crank-Nicolson and log-price solvers");
+
+    // Rebate only (r = q = 0): the rebate times the probability of hitting 80
+    const BlackScholesModel driftless(0.0, 0.3, 0.0);
+    BarrierOption rebateOnly(BarrierOption::Type::DownAndOutPut, 0.0, 80.0, T, driftless, 1.0);
+    auto Phi = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+    const double nu = -0.5 * 0.3 * 0.3, sd = 0.3 * std::sqrt(T), h = std::log(80.0 / S0);
+    const double hitProbability = Phi((h - nu * T) / sd) + std::exp(2.0 * nu * h / (0.3 * 0.3)) * Phi((h + nu * T) / sd);
+    check(approx(solver.price(rebateOnly, driftless, GridParameters::makeGrid(rebateOnly, driftless, S0, 0.005), S0).price,
+                 hitProbability, 1e-4),
+          "Barrier rebate ~ first-passage probability");
+
+    // Monthly monitoring ~ continuous barrier shifted by exp(-0.5826 sigma sqrt(dt)) (Broadie-Glasserman-Kou)
+    std::vector<double> monthly;
+    for (int k = 1; k <= 12; ++k) monthly.push_back(T * k / 12.0);
+    BarrierOption monthlyOut(BarrierOption::Type::DownAndOutCall, K, H, T, model, 0.0, monthly);
+    const double Hshift = H * std::exp(-0.5826 * sigma * std::sqrt(T / 12.0));
+    const double monthlyRef = analytic.price(euroCall, model, S0).price
+                              - std::pow(Hshift / S0, 2.0 * lambda - 2.0) * analytic.price(euroCall, model, Hshift * Hshift / S0).price;
+    const double monthlyPrice = solver.price(monthlyOut, model, GridParameters::makeGrid(monthlyOut, model, S0, 0.005), S0).price;
+    bool rejectsFullGrid = false;
+    try { solver.price(downOut, model, vanillaGrid, S0); } catch (const std::invalid_argument&) { rejectsFullGrid = true; }
+    check(approx(monthlyPrice, monthlyRef, 1e-2) && monthlyPrice > barrierPrice && rejectsFullGrid,
+          "Discretely monitored knock-out ~ shifted-barrier closed form; continuous barrier off the grid ends rejected");
+
+    // Engine batch: knock-outs on their own grids, whatever their place among vanillas
+    const std::vector<const InterfaceProducts*> mixed{&downOut, &amerPut, &monthlyOut, &amerCall};
+    const std::vector<const InterfaceProducts*> mixedReversed(mixed.rbegin(), mixed.rend());
+    const auto mixedBatch = engine.priceBatch(mixed, model, S0);
+    const auto reversedBatch = engine.priceBatch(mixedReversed, model, S0);
+    bool mixedMatches = true;
+    for (std::size_t k = 0; k < mixed.size(); ++k) {
+        const double single = engine.price(*mixed[k], model, S0).result.price;
+        mixedMatches = mixedMatches && approx(mixedBatch[k].result.price, single, 1e-12)
+                       && approx(reversedBatch[mixed.size() - 1 - k].result.price, single, 1e-12);
+    }
+    check(mixedMatches, "Engine batch: knock-outs among vanillas (either order) == single-product prices");
+    check(ProductFactory::parse("up_and_out_call") == ProductType::UpAndOutCall
+          && ProductFactory::make(ProductType::DownAndOutPut, K, H, T, model)->lowerBarrier() == H,
+          "Knock-out product types (K2 = barrier)");
+
+    // 30) Reduced precision: float storage within tolerance of double, SIMD == scalar
+    const FdGrid coarseGrid = GridParameters::makeGrid(euroCall, model, S0, 0.01);
+    const std::vector<ExplicitFdSolver::PrecisionSample> precisionSamples{
+        {&euroCall, model, coarseGrid, S0}, {&amerPut, model, coarseGrid, S0}, {&straddle, model, coarseGrid, 90.0}};
+    const auto floatReport = solver.checkPrecision(ExplicitFdSolver::Precision::Float, precisionSamples);
+    const auto mixedReport = solver.checkPrecision(ExplicitFdSolver::Precision::Mixed, precisionSamples);
+    check(floatReport.samples == 3 && floatReport.maxPriceError < 1e-3 && floatReport.maxDeltaError < 1e-4
+          && floatReport.maxGammaError < 1e-4 && mixedReport.maxPriceError < 1e-3 && mixedReport.maxDeltaError < 1e-4,
+          "Float and mixed precision ~ double on sample trades");
+
+    bool reducedBitwise = true;
+    for (auto precision : {ExplicitFdSolver::Precision::Float, ExplicitFdSolver::Precision::Mixed}) {
+        ExplicitFdSolver reducedScalar(stencil::SimdLevel::Scalar);
+        ExplicitFdSolver reducedBest;
+        reducedScalar.setPrecision(precision);
+        reducedBest.setPrecision(precision);
+        for (const InterfaceProducts* option : {static_cast<const InterfaceProducts*>(&euroCall),
+                                                static_cast<const InterfaceProducts*>(&amerPut)})
+            reducedBitwise = reducedBitwise && reducedScalar.price(*option, model, coarseGrid, S0).V0
+                                               == reducedBest.price(*option, model, coarseGrid, S0).V0;
+    }
+    check(reducedBitwise, "Float and mixed SIMD kernels == scalar reference (bitwise)");
+
+    // 31) Two-asset ADI: exchange option ~ Margrabe, max and basket identities
+    const TwoAssetModel twoAssets(r, 0.2, 0.3, 0.5, q, 0.01);
+    const double S2 = 95.0;
+    SpreadOption exchange(SpreadOption::Type::Call, 0.0, T);
+    const FdGrid2D grid2D = GridParameters::makeGrid(exchange, twoAssets, S0, S2, 0.02);
+    const double margrabe = AnalyticBsPricer::exchangeOption(twoAssets, S0, S2, T);
+    AdiFdSolver craigSneyd;
+    const AdiFdSolver::Result exchangeCS = craigSneyd.price(exchange, twoAssets, grid2D, S0, S2);
+    check(approx(exchangeCS.price, margrabe, 5e-3)
+          && approx(AdiFdSolver(AdiFdSolver::Scheme::Douglas).price(exchange, twoAssets, grid2D, S0, S2).price, margrabe, 5e-2),
+          "Exchange option (Craig-Sneyd, Douglas ADI) ~ Margrabe");
+
+    // max(S1, S2) = S2 + max(S1 - S2, 0); basket put-call parity; early exercise
+    MaxOption maxCall(MaxOption::Type::Call, 0.0, T);
+    BasketOption basketCall(BasketOption::Type::Call, K, T, 0.5, 0.5);
+    BasketOption basketPut(BasketOption::Type::Put, K, T, 0.5, 0.5);
+    BasketOption amerBasketPut(BasketOption::Type::Put, K, T, 0.5, 0.5, true);
+    const double basketPutPrice = craigSneyd.price(basketPut, twoAssets, grid2D, S0, S2).price;
+    const double basketForward = 0.5 * S0 * std::exp(-q * T) + 0.5 * S2 * std::exp(-0.01 * T) - K * std::exp(-r * T);
+    check(approx(craigSneyd.price(maxCall, twoAssets, grid2D, S0, S2).price, S2 * std::exp(-0.01 * T) + exchangeCS.price, 1e-2)
+          && approx(craigSneyd.price(basketCall, twoAssets, grid2D, S0, S2).price - basketPutPrice, basketForward, 1e-3)
+          && craigSneyd.price(amerBasketPut, twoAssets, grid2D, S0, S2).price > basketPutPrice,
+          "Max-option and basket parities, American basket put > European");
+
+    AdiFdSolver pooledAdi;
+    pooledAdi.setThreadPool(&pool);
+    check(pooledAdi.price(exchange, twoAssets, grid2D, S0, S2).V0 == exchangeCS.V0,
+          "Two-asset ADI: parallel line solves == serial (bitwise)");
+
     std::cout << "\n--- Values (for info) ---\n";
     std::cout << "C=" << C.price << "  P=" << P.price << "  F=" << F.price << "\n";
     std::cout << "AP=" << AP.price << "  AC=" << AC.price << "\n";
     std::cout << "Bull=" << Bull.price << "  Bear=" << Bear.price << "  Str=" << Str.price << "\n";
+    std::cout << "C(CN)=" << Ccn.price << "  AP(CN)=" << APcn.price << "  C(implicit)=" << Cimp.price
+              << "  Nt(explicit)=" << grid.Nt() << "  Nt(CN)=" << cnGrid.Nt() << "\n";
 
     return 0;
 }